@@ -0,0 +1,36 @@
+#pragma once
+
+#include "game_state.h"
+#include <vector>
+
+// every plane is stored row by row: plane[row * stride + game], so the same row of many games is contiguous
+// and the collision and row clear checks can run over 8 (SSE2) or 16 (AVX2) games at the same time.
+typedef struct
+{
+    int totalGames;
+    int stride;
+    std::vector<uint16_t> boardRows;
+    // the falling block of each game, already drawn as row masks.
+    std::vector<uint16_t> blockRows;
+    std::vector<int16_t> rowOffsets;
+    std::vector<uint16_t> isGameOver;
+    std::vector<int8_t> ids;
+    std::vector<int8_t> rotations;
+    std::vector<int8_t> columnOffsets;
+    std::vector<int32_t> scores;
+    std::vector<PieceQueue> queues;
+    std::vector<Random> randoms;
+    // scratch bits written by the vector pass, one bit per game.
+    std::vector<uint32_t> lockedGames;
+    std::vector<uint32_t> fullRowGames;
+} GameBatch;
+
+void createGameBatch(GameBatch &batch, int totalGames, uint64_t seed);
+
+void resetBatchGame(GameBatch &batch, int game, uint64_t seed);
+
+bool moveBatchBlock(GameBatch &batch, int game, int columnsToMove);
+
+void rotateBatchBlock(GameBatch &batch, int game);
+
+void tickGameBatch(GameBatch &batch);
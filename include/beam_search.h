@@ -0,0 +1,13 @@
+#pragma once
+
+#include "bot.h"
+
+const int DEFAULT_BEAM_WIDTH = 32;
+const int MAX_BEAM_WIDTH = 128;
+// the current block and every block of the preview.
+const int MAX_SEARCH_DEPTH = MAX_PREVIEW_DEPTH + 1;
+
+// places the current block and then the next ones of the queue, keeping only the best beamWidth boards after every block.
+// The nodes of a ply are expanded in parallel, and when the time budget runs out the last complete ply decides.
+// false when the block can't be placed anywhere.
+bool findBeamPlacement(const Board &board, const Block &block, const PieceQueue &queue, const SearchConfig &config, const BotWeights &weights, Placement &bestPlacement);
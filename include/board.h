@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stdint.h>
+
+const int TOTAL_ROWS = 18;
+const int TOTAL_COLUMNS = 10;
+
+const uint16_t FULL_ROW_MASK = (1 << TOTAL_COLUMNS) - 1;
+
+typedef struct
+{
+    // one occupancy bit per cell, bit 0 is the leftmost column.
+    uint16_t rows[TOTAL_ROWS];
+    // the same bits by column, bit r is the row r, so the drop of a block is a bit scan per column.
+    uint32_t columns[TOTAL_COLUMNS];
+    // 4 bits per cell with the id of the block that was locked there, only used for drawing.
+    uint64_t cellIds[TOTAL_ROWS];
+    // XOR of the Zobrist keys of the filled cells, setCell and clearFullRows keep it up to date.
+    uint64_t hash;
+} Board;
+
+void clearBoard(Board &board);
+
+bool isCellEmpty(const Board &board, int row, int column);
+
+int getCellId(const Board &board, int row, int column);
+
+void setCell(Board &board, int row, int column, int id);
+
+bool isRowFull(const Board &board, int row);
+
+int clearFullRows(Board &board);
+
+// only the occupancy masks, for boards stored with a stride between rows like the batched games.
+int clearFullRows(uint16_t *rows, int rowStride);
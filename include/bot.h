@@ -0,0 +1,70 @@
+#pragma once
+
+#include "move_generator.h"
+#include "thread_pool.h"
+#include "transposition_table.h"
+
+// how much every feature of the board is worth, the bot picks the placement with the highest sum.
+typedef struct
+{
+    float aggregateHeight;
+    float holes;
+    float bumpiness;
+    float wells;
+    float rowTransitions;
+    float columnTransitions;
+    float clearedRows;
+} BotWeights;
+
+typedef struct
+{
+    int aggregateHeight;
+    int holes;
+    int bumpiness;
+    int wells;
+    int rowTransitions;
+    int columnTransitions;
+    int clearedRows;
+} BoardFeatures;
+
+// with a depth above 1 the bot runs a beam search over the next blocks of the preview (see beam_search.h).
+// A time budget of 0 means no limit, and without a pool the search runs in the calling thread.
+// The table caches the evaluation of the boards between searches, it must always be used with the same weights.
+typedef struct
+{
+    int depth;
+    int beamWidth;
+    double timeBudget;
+    ThreadPool *pool;
+    TranspositionTable *table;
+} SearchConfig;
+
+// the bot follows the path of its placement one action at a time, and plans again when the block is not where it expected.
+typedef struct
+{
+    Placement placement;
+    PlacementPath path;
+    int nextAction;
+    int plannedPieces;
+    Block expectedBlock;
+    bool hasPlan;
+    SearchConfig search;
+} Bot;
+
+extern const BotWeights DEFAULT_BOT_WEIGHTS;
+
+// locks the block in the occupancy rows and clears the full ones, returns the cleared rows.
+int placeBlock(uint16_t rows[TOTAL_ROWS], const Block &block);
+
+void getBoardFeatures(const uint16_t rows[TOTAL_ROWS], int clearedRows, BoardFeatures &features);
+
+float evaluateBoard(const BoardFeatures &features, const BotWeights &weights);
+
+// false when the block can't be placed anywhere.
+bool findBestPlacement(const Board &board, const Block &block, const BotWeights &weights, Placement &bestPlacement);
+
+// forgets the current plan, the search config is kept.
+void resetBot(Bot &bot);
+
+// the next input for the game, after the path it keeps moving down so the block locks.
+Action getBotAction(Bot &bot, const GameState &state, const BotWeights &weights);
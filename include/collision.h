@@ -0,0 +1,18 @@
+#pragma once
+
+#include "board.h"
+#include "pieces.h"
+
+void getCellPositions(const Block &block, CellOffset cells[CELLS_PER_BLOCK]);
+
+bool pieceFits(const Board &board, int id, int rotation, int row, int column);
+
+// same test for boards stored with a stride between rows, like the batched games.
+bool pieceFits(const uint16_t *rows, int rowStride, int id, int rotation, int row, int column);
+
+bool blockFits(const Board &board, const Block &block);
+
+// the lowest row the block reaches falling straight down from where it fits, without probing row by row.
+int findLandingRow(const Board &board, int id, int rotation, int row, int column);
+
+int findLandingRow(const Board &board, const Block &block);
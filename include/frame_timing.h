@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+// the last FRAME_SAMPLES frames are kept, around 17 seconds at 60 fps.
+const int FRAME_SAMPLES = 1024;
+
+// every frame since the start also goes in a histogram of microseconds, 32 buckets per power of two
+// (within 3%), so a long run or the benchmark gets percentiles over all of its frames.
+const int HISTOGRAM_BUCKETS = 1024;
+
+// the parts of one iteration of the main loop, PHASE_FRAME is the whole iteration.
+enum FramePhase
+{
+    PHASE_CONTROLLER,
+    PHASE_EVENTS,
+    PHASE_UPDATE,
+    PHASE_SOUNDS,
+    PHASE_RENDER,
+    PHASE_FRAME_CAP,
+    PHASE_FRAME,
+    TOTAL_FRAME_PHASES
+};
+
+// the times are in performance counter ticks, they are only turned into milliseconds when printed.
+typedef struct
+{
+    uint64_t samples[TOTAL_FRAME_PHASES][FRAME_SAMPLES];
+    // the worst time since the start, it survives the ring buffer wrapping around.
+    uint64_t maxSamples[TOTAL_FRAME_PHASES];
+    uint32_t histogram[TOTAL_FRAME_PHASES][HISTOGRAM_BUCKETS];
+    uint64_t frequency;
+    uint64_t totalFrames;
+    int nextSample;
+    int totalSamples;
+} FrameTimer;
+
+void resetFrameTimer(FrameTimer &timer, uint64_t frequency);
+
+// stores the time since start in the current frame and returns now, to be the start of the next phase.
+uint64_t markPhase(FrameTimer &timer, FramePhase phase, uint64_t start, uint64_t now);
+
+void endFrame(FrameTimer &timer);
+
+// p50, p95, p99 and max of every phase over the frames in the buffer, and again over all the frames since the start.
+void printFrameTimings(const FrameTimer &timer, FILE *file);
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "board.h"
+#include "piece_queue.h"
+
+const int MAX_GAME_EVENTS = 32;
+const uint32_t ALL_ROWS_DIRTY = (1 << TOTAL_ROWS) - 1;
+
+// the game runs in fixed ticks, the block falls one row every GRAVITY_TICKS ticks (half a second).
+const int TICKS_PER_SECOND = 60;
+const int GRAVITY_TICKS = 30;
+
+// things that happened inside the game that the front-end may want to react to, like playing a sound.
+enum GameEvent
+{
+    BLOCK_ROTATED,
+    BLOCK_LOCKED,
+    ROW_CLEARED,
+    GAME_PAUSED,
+    GAME_OVER
+};
+
+// the inputs a player (or a bot) can give to the falling block.
+enum Action
+{
+    ACTION_LEFT,
+    ACTION_RIGHT,
+    ACTION_ROTATE,
+    ACTION_DOWN,
+    // straight to the wall, for the auto repeat without delay.
+    ACTION_LEFT_WALL,
+    ACTION_RIGHT_WALL
+};
+
+typedef struct
+{
+    Board board;
+    Block currentBlock;
+    // the next blocks, peekPiece(queue, 0) is the one shown as next.
+    PieceQueue queue;
+    uint64_t seed;
+    Random random;
+    int score;
+    int totalLines;
+    int totalPieces;
+    bool isGameOver;
+    bool isGamePaused;
+    // the ticks since the block last fell, and since the game started.
+    int gravityTicks;
+    uint64_t totalTicks;
+    GameEvent events[MAX_GAME_EVENTS];
+    int totalEvents;
+    // one bit per board row that changed since the front-end last drew it, the front-end clears it.
+    uint32_t dirtyRows;
+} GameState;
+
+int getClearScore(int totalClearRows);
+
+void resetGame(GameState &state, uint64_t seed);
+
+void clearEvents(GameState &state);
+
+void togglePause(GameState &state);
+
+bool moveBlock(GameState &state, int rowsToMove, int columnsToMove);
+
+void rotateBlock(GameState &state);
+
+void lockBlock(GameState &state);
+
+void moveBlockDown(GameState &state);
+
+void softDrop(GameState &state);
+
+// moves the block as far as it goes in that direction, in one step.
+void shiftToWall(GameState &state, int direction);
+
+void tickGame(GameState &state);
+
+void applyAction(GameState &state, Action action);
+
+// the Zobrist hash of the board, the falling block and the preview.
+uint64_t getGameHash(const GameState &state);
+
+// one tick of the game, gravity included.
+void updateGame(GameState &state);
+
+// the same as calling updateGame until totalTicks is tick, one gravity step at a time instead of one tick at a time.
+void updateGameUntil(GameState &state, uint64_t tick);
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "rect_batch.h"
+#include <SDL2/SDL_ttf.h>
+
+// the printable ascii characters, anything else is drawn as a space.
+const int FIRST_ATLAS_GLYPH = 32;
+const int LAST_ATLAS_GLYPH = 126;
+const int TOTAL_ATLAS_GLYPHS = LAST_ATLAS_GLYPH - FIRST_ATLAS_GLYPH + 1;
+const int ATLAS_WIDTH = 512;
+
+typedef struct
+{
+    // where the glyph is in the atlas, in pixels and in the normalized coordinates of the texture.
+    SDL_Rect bounds;
+    SDL_FRect textureRect;
+    int advance;
+} AtlasGlyph;
+
+// every glyph of one font and size rasterized once in white, the text color comes from the vertices.
+typedef struct
+{
+    SDL_Texture *texture;
+    AtlasGlyph glyphs[TOTAL_ATLAS_GLYPHS];
+    int height;
+} GlyphAtlas;
+
+bool createGlyphAtlas(GlyphAtlas &atlas, TTF_Font *font, SDL_Renderer *renderer);
+
+void destroyGlyphAtlas(GlyphAtlas &atlas);
+
+int getTextWidth(const GlyphAtlas &atlas, const char *text);
+
+// one quad per character with the top left corner of the text at the position, drawn with drawRectBatch and the atlas texture.
+void addText(RectBatch &batch, const GlyphAtlas &atlas, const char *text, int positionX, int positionY, SDL_Color color);
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "game_state.h"
+
+const int MAX_INPUT_TRANSITIONS = 64;
+
+// every transition of a tick can give an action, and the held shift and soft drop one more each.
+const int MAX_INPUT_ACTIONS = MAX_INPUT_TRANSITIONS + 2;
+
+// the rotation goes through the same transitions so every action keeps the order of the events, but it never repeats.
+enum InputButton
+{
+    BUTTON_LEFT,
+    BUTTON_RIGHT,
+    BUTTON_SOFT_DROP,
+    BUTTON_ROTATE,
+    TOTAL_INPUT_BUTTONS
+};
+
+// all in game ticks. A held direction moves once, waits dasTicks and then moves every arrTicks,
+// arrTicks = 0 moves the block to the wall at once. The soft drop moves every softDropTicks.
+typedef struct
+{
+    int dasTicks;
+    int arrTicks;
+    int softDropTicks;
+} InputConfig;
+
+const InputConfig DEFAULT_INPUT_CONFIG = {10, 2, 1};
+
+typedef struct
+{
+    InputButton button;
+    bool isPressed;
+    uint64_t tick;
+} InputTransition;
+
+// the presses and releases wait here until the tick they happened in, so the moves don't depend on the frame rate.
+typedef struct
+{
+    InputConfig config;
+    InputTransition transitions[MAX_INPUT_TRANSITIONS];
+    int totalTransitions;
+    bool isHeld[TOTAL_INPUT_BUTTONS];
+    int heldTicks[TOTAL_INPUT_BUTTONS];
+    // the direction pressed last wins when both are held.
+    int shiftDirection;
+} InputState;
+
+void resetInput(InputState &input, const InputConfig &config);
+
+// the tick of an event at time, when the frame covers the times from frameStart to frameEnd and runs totalTicks ticks from firstTick.
+uint64_t getInputTick(uint32_t time, uint32_t frameStart, uint32_t frameEnd, uint64_t firstTick, int totalTicks);
+
+void pushInput(InputState &input, InputButton button, bool isPressed, uint64_t tick);
+
+// for the times the game doesn't tick (paused, idle, a new game): the waiting transitions only change
+// which buttons are held, they never become actions.
+void settleInput(InputState &input);
+
+// the actions of the transitions up to this tick and of the held buttons, once per game tick.
+// They only depend on the input, so they can be recorded and played again without it.
+int updateInput(InputState &input, uint64_t tick, Action actions[MAX_INPUT_ACTIONS]);
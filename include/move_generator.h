@@ -0,0 +1,39 @@
+#pragma once
+
+#include "game_state.h"
+
+const int MAX_PLACEMENTS = 256;
+const int MAX_PATH_LENGTH = 64;
+
+// the column masks start at column -3, where a block can still have cells inside the board.
+const int MOVE_COLUMN_BIAS = 3;
+
+// a final position of the block, findPlacementPath gives the actions that take it there.
+typedef struct
+{
+    Block block;
+} Placement;
+
+// the path leaves the block resting on its landing row, the next move down (or gravity) locks it.
+typedef struct
+{
+    uint8_t length;
+    uint8_t actions[MAX_PATH_LENGTH];
+} PlacementPath;
+
+typedef struct
+{
+    int totalPlacements;
+    Placement placements[MAX_PLACEMENTS];
+} PlacementList;
+
+// every distinct place where the block can be locked using the same moves as moveBlock and rotateBlock,
+// assuming the player is faster than gravity. Two placements that leave the same cells filled count once.
+void generatePlacements(const Board &board, const Block &start, PlacementList &placements);
+
+// the actions from start to one of its placements, only the placement the caller picks needs them.
+// false when the placement can't be reached or the path is longer than MAX_PATH_LENGTH.
+bool findPlacementPath(const Board &board, const Block &start, const Block &placement, PlacementPath &path);
+
+// bit c + MOVE_COLUMN_BIAS is set when the block fits at column c in that row, it covers the columns from -3 to 12.
+uint16_t getFittingColumns(const Board &board, int id, int rotation, int row);
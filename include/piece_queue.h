@@ -0,0 +1,30 @@
+#pragma once
+
+#include "pieces.h"
+#include "random.h"
+
+const int MIN_PREVIEW_DEPTH = 1;
+const int MAX_PREVIEW_DEPTH = 14;
+
+// a full bag can be pushed while there are still MAX_PREVIEW_DEPTH - 1 ids waiting, 32 is the next power of two.
+const int PIECE_QUEUE_CAPACITY = 32;
+
+// ring buffer with the ids of the next blocks, refilled with shuffled bags of the 7 blocks.
+typedef struct
+{
+    int8_t ids[PIECE_QUEUE_CAPACITY];
+    uint8_t first;
+    uint8_t totalIds;
+    uint8_t depth;
+} PieceQueue;
+
+void resetPieceQueue(PieceQueue &queue, Random &random, int depth);
+
+void setPreviewDepth(PieceQueue &queue, Random &random, int depth);
+
+int takePiece(PieceQueue &queue, Random &random);
+
+inline int peekPiece(const PieceQueue &queue, int index)
+{
+    return queue.ids[(queue.first + index) & (PIECE_QUEUE_CAPACITY - 1)];
+}
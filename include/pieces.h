@@ -0,0 +1,75 @@
+#pragma once
+
+#include <stdint.h>
+#include <type_traits>
+
+const int TOTAL_BLOCK_TYPES = 7;
+const int TOTAL_ROTATIONS = 4;
+const int CELLS_PER_BLOCK = 4;
+
+typedef struct
+{
+    int8_t row;
+    int8_t column;
+} CellOffset;
+
+// all the tables are indexed by block id, id 0 is the empty cell so it doesn't have any rotation.
+constexpr int8_t BLOCK_ROTATIONS[TOTAL_BLOCK_TYPES + 1] = {0, 4, 4, 4, 1, 4, 4, 4};
+
+// for all the block to start in the midle of the grid, they spawn in the column 3 (the o block in 4, and the i block one row up)
+constexpr int8_t SPAWN_ROWS[TOTAL_BLOCK_TYPES + 1] = {0, 0, 0, -1, 0, 0, 0, 0};
+constexpr int8_t SPAWN_COLUMNS[TOTAL_BLOCK_TYPES + 1] = {0, 3, 3, 3, 4, 3, 3, 3};
+
+constexpr CellOffset BLOCK_CELLS[TOTAL_BLOCK_TYPES + 1][TOTAL_ROTATIONS][CELLS_PER_BLOCK] = {
+    // empty
+    {},
+    // l block
+    {{{0, 2}, {1, 0}, {1, 1}, {1, 2}},
+     {{0, 1}, {1, 1}, {2, 1}, {2, 2}},
+     {{1, 0}, {1, 1}, {1, 2}, {2, 0}},
+     {{0, 0}, {0, 1}, {1, 1}, {2, 1}}},
+    // j block
+    {{{0, 0}, {1, 0}, {1, 1}, {1, 2}},
+     {{0, 1}, {0, 2}, {1, 1}, {2, 1}},
+     {{1, 0}, {1, 1}, {1, 2}, {2, 2}},
+     {{0, 1}, {1, 1}, {2, 0}, {2, 1}}},
+    // i block
+    {{{1, 0}, {1, 1}, {1, 2}, {1, 3}},
+     {{0, 2}, {1, 2}, {2, 2}, {3, 2}},
+     {{2, 0}, {2, 1}, {2, 2}, {2, 3}},
+     {{0, 1}, {1, 1}, {2, 1}, {3, 1}}},
+    // o block, I don't need rotation with this block
+    {{{0, 0}, {0, 1}, {1, 0}, {1, 1}}},
+    // s block
+    {{{0, 1}, {0, 2}, {1, 0}, {1, 1}},
+     {{0, 1}, {1, 1}, {1, 2}, {2, 2}},
+     {{1, 1}, {1, 2}, {2, 0}, {2, 1}},
+     {{0, 0}, {1, 0}, {1, 1}, {2, 1}}},
+    // t block
+    {{{0, 1}, {1, 0}, {1, 1}, {1, 2}},
+     {{0, 1}, {1, 1}, {1, 2}, {2, 1}},
+     {{1, 0}, {1, 1}, {1, 2}, {2, 1}},
+     {{0, 1}, {1, 0}, {1, 1}, {2, 1}}},
+    // z block
+    {{{0, 0}, {0, 1}, {1, 1}, {1, 2}},
+     {{0, 2}, {1, 1}, {1, 2}, {2, 1}},
+     {{1, 0}, {1, 1}, {2, 1}, {2, 2}},
+     {{0, 1}, {1, 0}, {1, 1}, {2, 0}}},
+};
+
+typedef struct
+{
+    int8_t id;
+    int8_t rotationState;
+    int8_t rowOffset;
+    int8_t columnOffset;
+} Block;
+
+static_assert(std::is_trivially_copyable<Block>::value, "Block is copied around a lot, it needs to stay a plain struct");
+
+inline Block createBlock(int id)
+{
+    Block block = {(int8_t)id, 0, SPAWN_ROWS[id], SPAWN_COLUMNS[id]};
+
+    return block;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <stdint.h>
+
+// xoshiro256** generator, every game owns one so the piece sequence only depends on its seed.
+typedef struct
+{
+    uint64_t state[4];
+} Random;
+
+uint64_t splitMix(uint64_t &value);
+
+void seedRandom(Random &random, uint64_t seed);
+
+uint64_t nextRandom(Random &random);
+
+int randomRange(Random &random, int min, int max);
+
+// advances the generator 2^128 steps, calling it once per worker gives each one a stream that never overlaps with the others.
+void jumpRandom(Random &random);
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+
+// the whole playfield with the ui boxes, the falling block and the next one.
+const int MAX_BATCH_RECTS = 256;
+
+// solid rects collected during the frame and drawn with one SDL_RenderGeometry call, in the order they were added.
+typedef struct
+{
+    SDL_Vertex vertices[MAX_BATCH_RECTS * 4];
+    int indices[MAX_BATCH_RECTS * 6];
+    int totalRects;
+} RectBatch;
+
+// the indices never change, they are only written here.
+void createRectBatch(RectBatch &batch);
+
+void addRect(RectBatch &batch, const SDL_Rect &rect, SDL_Color color);
+
+// a rect that shows the part of the texture between the normalized coordinates, tinted by the color.
+void addTexturedRect(RectBatch &batch, const SDL_Rect &rect, const SDL_FRect &textureRect, SDL_Color color);
+
+// draws and empties the batch.
+void drawRectBatch(SDL_Renderer *renderer, RectBatch &batch);
+
+// the same for a batch of textured rects, all of them from the same texture.
+void drawRectBatch(SDL_Renderer *renderer, RectBatch &batch, SDL_Texture *texture);
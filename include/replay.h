@@ -0,0 +1,89 @@
+#pragma once
+
+#include "game_state.h"
+
+const uint32_t REPLAY_MAGIC = 0x4C505254; // "TRPL"
+const int REPLAY_VERSION = 1;
+
+// the action goes in the low bits of every record, the ticks since the last record in the rest.
+const int REPLAY_ACTION_BITS = 3;
+const int MAX_VARINT_BYTES = 10;
+
+// reserved once, at 1 or 2 bytes per action it holds hours of play. A longer game keeps its first part.
+const int MAX_REPLAY_BYTES = 1 << 20;
+
+// what a replay says about the end of its game.
+typedef struct
+{
+    uint64_t totalTicks;
+    int score;
+    int totalLines;
+    int totalPieces;
+    uint64_t gameHash;
+} ReplayResult;
+
+enum ReplayStatus
+{
+    REPLAY_VALID,
+    // not a replay, or cut short.
+    REPLAY_CORRUPT,
+    // another version, or a game with other rules.
+    REPLAY_UNSUPPORTED,
+    // the buffer filled up while recording, the end of the game is missing.
+    REPLAY_TRUNCATED,
+    // the actions don't give the recorded result.
+    REPLAY_MISMATCH,
+    TOTAL_REPLAY_STATUSES
+};
+
+// a game is its seed, its starting config and the actions, each with the game tick it was applied before.
+// The file is the header, the records as varints and a footer with how the game ended:
+// magic, version, seed (8 bytes), preview depth, gravity ticks, total actions, records...,
+// total ticks, score, lines, pieces, truncated (1 byte), game hash (8 bytes).
+typedef struct
+{
+    uint64_t seed;
+    int previewDepth;
+    int gravityTicks;
+    uint64_t lastTick;
+    int totalActions;
+    int totalBytes;
+    bool isTruncated;
+    bool isFinished;
+    uint8_t bytes[MAX_REPLAY_BYTES];
+} Replay;
+
+int writeVarint(uint8_t *bytes, uint64_t value);
+
+// false when the varint goes past end or is longer than MAX_VARINT_BYTES.
+bool readVarint(const uint8_t *&bytes, const uint8_t *end, uint64_t &value);
+
+// call it right after resetGame.
+void startReplay(Replay &replay, const GameState &state);
+
+inline void recordAction(Replay &replay, uint64_t tick, Action action)
+{
+    if (replay.totalBytes > MAX_REPLAY_BYTES - MAX_VARINT_BYTES)
+    {
+        replay.isTruncated = true;
+        return;
+    }
+
+    uint64_t record = ((tick - replay.lastTick) << REPLAY_ACTION_BITS) | action;
+
+    replay.lastTick = tick;
+    replay.totalBytes += writeVarint(replay.bytes + replay.totalBytes, record);
+    replay.totalActions++;
+}
+
+// writes the replay of the finished game in directory, named after its seed. Returns false when the file can't be written.
+bool saveReplay(Replay &replay, const GameState &state, const char *directory);
+
+const char *getReplayStatusName(ReplayStatus status);
+
+// takes the contents of a replay file apart, the records are copied in replay.
+ReplayStatus readReplay(Replay &replay, ReplayResult &result, const uint8_t *bytes, int totalBytes);
+
+// plays the actions through the game logic from the seed, with no rendering and no waiting between the ticks,
+// and compares the end of the game with the recorded result. state is the game at the end.
+ReplayStatus verifyReplay(const Replay &replay, const ReplayResult &result, GameState &state);
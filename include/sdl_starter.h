@@ -1,11 +1,41 @@
 #pragma once
 
 #include <SDL2/SDL.h>
+#include <stdio.h>
 
 const int SCREEN_WIDTH = 960;
 const int SCREEN_HEIGHT = 544;
+// used when the refresh rate of the display is unknown.
 const int FRAME_RATE = 60;
 
+// the sleep can wake up this late, the rest of the frame is spent spinning on the performance counter.
+const double PACER_SPIN_MILLISECONDS = 2.0;
+
+// keeps the frames at a fixed period, the deadlines are in performance counter ticks.
+typedef struct
+{
+    Uint64 frequency;
+    Uint64 frameTicks;
+    Uint64 nextDeadline;
+    int frameRate;
+    // how late every frame woke up after its deadline, frames that missed it by a whole frame start over from now.
+    Uint64 totalLateness;
+    Uint64 maxLateness;
+    int totalFrames;
+    int missedFrames;
+} FramePacer;
+
 int startSDL(SDL_Window *window, SDL_Renderer *renderer);
 
-void capFrameRate(Uint32 frameStartTime);
\ No newline at end of file
+// the refresh rate of the display the window is in, or FRAME_RATE when SDL doesn't know it.
+int getDisplayRefreshRate(SDL_Window *window);
+
+void startFramePacer(FramePacer &pacer, int frameRate);
+
+// sleeps most of the time until the next deadline and spins the rest.
+void waitNextFrame(FramePacer &pacer);
+
+// the next deadline is one frame from now, after the game didn't wait for the frames for a while.
+void restartFramePacer(FramePacer &pacer);
+
+void printFramePacer(const FramePacer &pacer, FILE *file);
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdint.h>
+
+// after a long stall (a dragged window, a breakpoint) the game skips the time over this many ticks instead of catching up.
+const int MAX_TICKS_PER_FRAME = 15;
+
+// turns the time of the rendered frames into fixed game ticks. The time is kept as counter ticks * TICKS_PER_SECOND,
+// so one game tick is exactly frequency units and nothing is lost to rounding between frames.
+typedef struct
+{
+    uint64_t frequency;
+    uint64_t lastTime;
+    uint64_t accumulator;
+    uint64_t totalTicks;
+} SimClock;
+
+void resetSimClock(SimClock &clock, uint64_t frequency, uint64_t now);
+
+// the game ticks to run in this frame, from 0 to MAX_TICKS_PER_FRAME.
+int advanceSimClock(SimClock &clock, uint64_t now);
+
+// forgets the time since the last frame, after the game was idle.
+void skipSimTime(SimClock &clock, uint64_t now);
+
+// how far the frame is between the last tick and the next one, from 0 to 1, for the renderer.
+float getSimAlpha(const SimClock &clock);
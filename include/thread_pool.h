@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+const int CACHE_LINE_SIZE = 64;
+const int MAX_WORKERS = 64;
+
+// the worker index goes from 0 to totalWorkers, the last one is the thread waiting in waitForTasks.
+typedef void (*TaskFunction)(void *data, int taskIndex, int workerIndex);
+
+typedef struct
+{
+    TaskFunction function;
+    void *data;
+    int taskIndex;
+} Task;
+
+// every worker owns one queue, it takes work from the back and the other workers steal from the front.
+struct alignas(CACHE_LINE_SIZE) WorkerQueue
+{
+    std::mutex mutex;
+    std::deque<Task> tasks;
+};
+
+// what one worker counts, kept in its own cache line so the workers never write to a shared one.
+// A tool has MAX_WORKERS + 1 of them, indexed by the worker index of its tasks, and adds them up at the end.
+template <typename Stats>
+struct alignas(CACHE_LINE_SIZE) WorkerShard
+{
+    Stats stats;
+};
+
+// it has over-aligned members, so it needs to be a global or live on the stack, not in new/vector.
+struct ThreadPool
+{
+    int totalWorkers;
+    std::thread threads[MAX_WORKERS];
+    WorkerQueue queues[MAX_WORKERS + 1];
+    std::atomic<int> queuedTasks;
+    std::atomic<int> unfinishedTasks;
+    std::atomic<int> nextQueue;
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+    bool isStopping;
+};
+
+int getDefaultWorkerCount();
+
+void startThreadPool(ThreadPool &pool, int totalWorkers);
+
+void submitTask(ThreadPool &pool, TaskFunction function, void *data, int taskIndex);
+
+void waitForTasks(ThreadPool &pool);
+
+void stopThreadPool(ThreadPool &pool);
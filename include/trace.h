@@ -0,0 +1,96 @@
+#pragma once
+
+// scoped trace zones, they only exist when the game is built with ENABLE_TRACING (make TRACE=1).
+// Without it TRACE_ZONE and TRACE_WRITE expand to nothing.
+#ifdef ENABLE_TRACING
+
+#include <atomic>
+#include <stdint.h>
+#include <x86intrin.h>
+
+const int TRACE_EVENTS_PER_THREAD = 1 << 17;
+const int MAX_TRACE_THREADS = 128;
+
+typedef struct
+{
+    const char *name;
+    uint64_t start;
+    uint64_t end;
+} TraceEvent;
+
+// only the owner thread writes in its buffer, it publishes every event by storing the new total after it.
+// When the buffer is full the next events are dropped.
+typedef struct
+{
+    TraceEvent events[TRACE_EVENTS_PER_THREAD];
+    std::atomic<int> totalEvents;
+    int threadId;
+} TraceBuffer;
+
+extern thread_local TraceBuffer *currentTraceBuffer;
+
+// the first event of every thread creates its buffer, null when there are already MAX_TRACE_THREADS.
+TraceBuffer *createTraceBuffer();
+
+// the Chrome trace format (chrome://tracing or ui.perfetto.dev), with every thread that traced something.
+void writeTraceFile(const char *filePath);
+
+// the time stamp counter is a lot cheaper to read than steady_clock, the ticks are turned into microseconds when the trace is written.
+inline uint64_t getTraceTime()
+{
+    return __rdtsc();
+}
+
+inline void addTraceEvent(const char *name, uint64_t start, uint64_t end)
+{
+    TraceBuffer *buffer = currentTraceBuffer;
+
+    if (buffer == nullptr)
+    {
+        buffer = createTraceBuffer();
+
+        if (buffer == nullptr)
+        {
+            return;
+        }
+    }
+
+    int totalEvents = buffer->totalEvents.load(std::memory_order_relaxed);
+
+    if (totalEvents == TRACE_EVENTS_PER_THREAD)
+    {
+        return;
+    }
+
+    buffer->events[totalEvents] = {name, start, end};
+    buffer->totalEvents.store(totalEvents + 1, std::memory_order_release);
+}
+
+struct TraceZone
+{
+    const char *name;
+    uint64_t start;
+
+    TraceZone(const char *zoneName)
+    {
+        name = zoneName;
+        start = getTraceTime();
+    }
+
+    ~TraceZone()
+    {
+        addTraceEvent(name, start, getTraceTime());
+    }
+};
+
+#define TRACE_JOIN_NAME(name, line) name##line
+#define TRACE_ZONE_NAME(name, line) TRACE_JOIN_NAME(name, line)
+#define TRACE_ZONE(name) TraceZone TRACE_ZONE_NAME(traceZone, __LINE__)(name)
+#define TRACE_WRITE(filePath) writeTraceFile(filePath)
+
+#else
+
+#define TRACE_ZONE(name)
+#define TRACE_WRITE(filePath)
+
+#endif
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+// 2^16 entries of 16 bytes, 1 MB.
+const int TRANSPOSITION_TABLE_BITS = 16;
+const int TRANSPOSITION_TABLE_SIZE = 1 << TRANSPOSITION_TABLE_BITS;
+
+// the entry keeps key ^ data next to the data, so a torn write from another thread just looks like a different key.
+// Nothing is locked, readers and writers only use relaxed atomic loads and stores.
+typedef struct
+{
+    std::atomic<uint64_t> check;
+    std::atomic<uint64_t> data;
+} TranspositionEntry;
+
+// it's big, so it needs to be a global and not live on the stack.
+typedef struct
+{
+    TranspositionEntry entries[TRANSPOSITION_TABLE_SIZE];
+} TranspositionTable;
+
+void clearTranspositionTable(TranspositionTable &table);
+
+bool probeTranspositionTable(const TranspositionTable &table, uint64_t key, float &value);
+
+// a new value always replaces the old one in the same slot.
+void storeTranspositionTable(TranspositionTable &table, uint64_t key, float value);
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "board.h"
+#include "pieces.h"
+#include "piece_queue.h"
+
+// a row is hashed in two chunks of 5 columns, each entry is the XOR of the keys of the filled cells of the chunk.
+const int ROW_CHUNK_COLUMNS = 5;
+const int TOTAL_ROW_CHUNKS = TOTAL_COLUMNS / ROW_CHUNK_COLUMNS;
+
+// a block can be 3 rows above the board and 3 columns to the left of it.
+const int BLOCK_KEY_BIAS = 3;
+
+typedef struct
+{
+    uint64_t rowChunks[TOTAL_ROWS][TOTAL_ROW_CHUNKS][1 << ROW_CHUNK_COLUMNS];
+    uint64_t blocks[TOTAL_BLOCK_TYPES + 1][TOTAL_ROTATIONS][TOTAL_ROWS + BLOCK_KEY_BIAS][TOTAL_COLUMNS + BLOCK_KEY_BIAS];
+    uint64_t previews[MAX_PREVIEW_DEPTH][TOTAL_BLOCK_TYPES + 1];
+} ZobristKeys;
+
+extern const ZobristKeys ZOBRIST_KEYS;
+
+inline uint64_t getRowHash(int row, uint16_t cells)
+{
+    return ZOBRIST_KEYS.rowChunks[row][0][cells & ((1 << ROW_CHUNK_COLUMNS) - 1)] ^ ZOBRIST_KEYS.rowChunks[row][1][cells >> ROW_CHUNK_COLUMNS];
+}
+
+inline uint64_t getCellHash(int row, int column)
+{
+    return ZOBRIST_KEYS.rowChunks[row][column / ROW_CHUNK_COLUMNS][1 << (column % ROW_CHUNK_COLUMNS)];
+}
+
+inline uint64_t getBlockHash(const Block &block)
+{
+    return ZOBRIST_KEYS.blocks[block.id][block.rotationState][block.rowOffset + BLOCK_KEY_BIAS][block.columnOffset + BLOCK_KEY_BIAS];
+}
+
+// the same value that setCell and clearFullRows keep in board.hash, computed from scratch.
+uint64_t getBoardHash(const uint16_t rows[TOTAL_ROWS]);
+
+// only the ids that are shown, the blocks that are still hidden in the bag don't change the position.
+uint64_t getPreviewHash(const PieceQueue &queue);
@@ -0,0 +1,278 @@
+#include "batch_sim.h"
+#include "collision.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+
+const int BATCH_LANES = 16;
+
+typedef __m256i Lanes;
+
+inline Lanes loadLanes(const void *source) { return _mm256_loadu_si256((const __m256i *)source); }
+inline void storeLanes(void *target, Lanes lanes) { _mm256_storeu_si256((__m256i *)target, lanes); }
+inline Lanes broadcastLanes(uint16_t value) { return _mm256_set1_epi16((short)value); }
+inline Lanes andLanes(Lanes a, Lanes b) { return _mm256_and_si256(a, b); }
+inline Lanes orLanes(Lanes a, Lanes b) { return _mm256_or_si256(a, b); }
+inline Lanes andNotLanes(Lanes mask, Lanes b) { return _mm256_andnot_si256(mask, b); }
+inline Lanes equalLanes(Lanes a, Lanes b) { return _mm256_cmpeq_epi16(a, b); }
+inline Lanes subtractLanes(Lanes a, Lanes b) { return _mm256_sub_epi16(a, b); }
+
+inline uint32_t laneBits(Lanes mask)
+{
+    // packing works inside each 128 bit half, so the bits of the high half end up at 16..23.
+    uint32_t bytes = _mm256_movemask_epi8(_mm256_packs_epi16(mask, mask));
+    return (bytes & 0xFF) | ((bytes >> 8) & 0xFF00);
+}
+
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+
+const int BATCH_LANES = 8;
+
+typedef __m128i Lanes;
+
+inline Lanes loadLanes(const void *source) { return _mm_loadu_si128((const __m128i *)source); }
+inline void storeLanes(void *target, Lanes lanes) { _mm_storeu_si128((__m128i *)target, lanes); }
+inline Lanes broadcastLanes(uint16_t value) { return _mm_set1_epi16((short)value); }
+inline Lanes andLanes(Lanes a, Lanes b) { return _mm_and_si128(a, b); }
+inline Lanes orLanes(Lanes a, Lanes b) { return _mm_or_si128(a, b); }
+inline Lanes andNotLanes(Lanes mask, Lanes b) { return _mm_andnot_si128(mask, b); }
+inline Lanes equalLanes(Lanes a, Lanes b) { return _mm_cmpeq_epi16(a, b); }
+inline Lanes subtractLanes(Lanes a, Lanes b) { return _mm_sub_epi16(a, b); }
+
+inline uint32_t laneBits(Lanes mask)
+{
+    return _mm_movemask_epi8(_mm_packs_epi16(mask, mask)) & 0xFF;
+}
+
+#else
+
+const int BATCH_LANES = 1;
+
+typedef uint16_t Lanes;
+
+inline Lanes loadLanes(const void *source) { return *(const uint16_t *)source; }
+inline void storeLanes(void *target, Lanes lanes) { *(uint16_t *)target = lanes; }
+inline Lanes broadcastLanes(uint16_t value) { return value; }
+inline Lanes andLanes(Lanes a, Lanes b) { return a & b; }
+inline Lanes orLanes(Lanes a, Lanes b) { return a | b; }
+inline Lanes andNotLanes(Lanes mask, Lanes b) { return ~mask & b; }
+inline Lanes equalLanes(Lanes a, Lanes b) { return a == b ? 0xFFFF : 0; }
+inline Lanes subtractLanes(Lanes a, Lanes b) { return a - b; }
+inline uint32_t laneBits(Lanes mask) { return mask != 0; }
+
+#endif
+
+// the stride is a multiple of 32 so every word of the scratch bits covers whole vectors.
+const int GAMES_PER_WORD = 32;
+
+inline Lanes selectLanes(Lanes mask, Lanes a, Lanes b)
+{
+    return orLanes(andLanes(mask, a), andNotLanes(mask, b));
+}
+
+void setBatchBlockCells(GameBatch &batch, int game, bool isVisible)
+{
+    const CellOffset *cells = BLOCK_CELLS[batch.ids[game]][batch.rotations[game]];
+
+    for (int i = 0; i < CELLS_PER_BLOCK; i++)
+    {
+        int row = batch.rowOffsets[game] + cells[i].row;
+        uint16_t cellMask = 1 << (batch.columnOffsets[game] + cells[i].column);
+        uint16_t &blockRow = batch.blockRows[row * batch.stride + game];
+
+        blockRow = isVisible ? blockRow | cellMask : blockRow & ~cellMask;
+    }
+}
+
+void spawnBatchBlock(GameBatch &batch, int game, int id)
+{
+    Block block = createBlock(id);
+
+    batch.ids[game] = block.id;
+    batch.rotations[game] = block.rotationState;
+    batch.rowOffsets[game] = block.rowOffset;
+    batch.columnOffsets[game] = block.columnOffset;
+
+    setBatchBlockCells(batch, game, true);
+
+    if (!pieceFits(&batch.boardRows[game], batch.stride, block.id, block.rotationState, block.rowOffset, block.columnOffset))
+    {
+        batch.isGameOver[game] = 1;
+    }
+}
+
+void createGameBatch(GameBatch &batch, int totalGames, uint64_t seed)
+{
+    batch.totalGames = totalGames;
+    batch.stride = (totalGames + GAMES_PER_WORD - 1) / GAMES_PER_WORD * GAMES_PER_WORD;
+
+    int stride = batch.stride;
+
+    batch.boardRows.assign(TOTAL_ROWS * stride, 0);
+    batch.blockRows.assign(TOTAL_ROWS * stride, 0);
+    batch.rowOffsets.assign(stride, 0);
+    // the padding games are never played, they only keep the vector loops without a tail.
+    batch.isGameOver.assign(stride, 1);
+    batch.ids.assign(stride, 0);
+    batch.rotations.assign(stride, 0);
+    batch.columnOffsets.assign(stride, 0);
+    batch.scores.assign(stride, 0);
+    batch.queues.assign(stride, PieceQueue());
+    batch.randoms.assign(stride, Random());
+    batch.lockedGames.assign(stride / GAMES_PER_WORD, 0);
+    batch.fullRowGames.assign(stride / GAMES_PER_WORD, 0);
+
+    for (int game = 0; game < totalGames; game++)
+    {
+        resetBatchGame(batch, game, splitMix(seed));
+    }
+}
+
+void resetBatchGame(GameBatch &batch, int game, uint64_t seed)
+{
+    seedRandom(batch.randoms[game], seed);
+    resetPieceQueue(batch.queues[game], batch.randoms[game], MIN_PREVIEW_DEPTH);
+
+    for (int row = 0; row < TOTAL_ROWS; row++)
+    {
+        batch.boardRows[row * batch.stride + game] = 0;
+        batch.blockRows[row * batch.stride + game] = 0;
+    }
+
+    batch.isGameOver[game] = 0;
+    batch.scores[game] = 0;
+
+    spawnBatchBlock(batch, game, takePiece(batch.queues[game], batch.randoms[game]));
+}
+
+bool moveBatchBlock(GameBatch &batch, int game, int columnsToMove)
+{
+    int column = batch.columnOffsets[game] + columnsToMove;
+
+    if (batch.isGameOver[game] || !pieceFits(&batch.boardRows[game], batch.stride, batch.ids[game], batch.rotations[game], batch.rowOffsets[game], column))
+    {
+        return false;
+    }
+
+    setBatchBlockCells(batch, game, false);
+    batch.columnOffsets[game] = column;
+    setBatchBlockCells(batch, game, true);
+
+    return true;
+}
+
+void rotateBatchBlock(GameBatch &batch, int game)
+{
+    int nextRotation = batch.rotations[game] + 1;
+
+    if (nextRotation == BLOCK_ROTATIONS[batch.ids[game]])
+    {
+        nextRotation = 0;
+    }
+
+    if (batch.isGameOver[game] || !pieceFits(&batch.boardRows[game], batch.stride, batch.ids[game], nextRotation, batch.rowOffsets[game], batch.columnOffsets[game]))
+    {
+        return;
+    }
+
+    setBatchBlockCells(batch, game, false);
+    batch.rotations[game] = nextRotation;
+    setBatchBlockCells(batch, game, true);
+}
+
+void finishBatchLock(GameBatch &batch, int game, bool hasFullRows)
+{
+    // same order as lockBlock: the next block is checked against the board before the rows are cleared.
+    spawnBatchBlock(batch, game, takePiece(batch.queues[game], batch.randoms[game]));
+
+    if (hasFullRows)
+    {
+        int totalClearRows = clearFullRows(&batch.boardRows[game], batch.stride);
+        batch.scores[game] += getClearScore(totalClearRows);
+    }
+}
+
+void tickGameBatch(GameBatch &batch)
+{
+    const int stride = batch.stride;
+    uint16_t *boardRows = batch.boardRows.data();
+    uint16_t *blockRows = batch.blockRows.data();
+
+    const Lanes zero = broadcastLanes(0);
+    const Lanes fullRow = broadcastLanes(FULL_ROW_MASK);
+
+    for (int word = 0; word < stride / GAMES_PER_WORD; word++)
+    {
+        batch.lockedGames[word] = 0;
+        batch.fullRowGames[word] = 0;
+    }
+
+    for (int game = 0; game < stride; game += BATCH_LANES)
+    {
+        Lanes isActive = equalLanes(loadLanes(&batch.isGameOver[game]), zero);
+
+        // a block that already touches the last row can't go down anymore.
+        Lanes collision = loadLanes(&blockRows[(TOTAL_ROWS - 1) * stride + game]);
+
+        for (int row = 0; row < TOTAL_ROWS - 1; row++)
+        {
+            Lanes blockRow = loadLanes(&blockRows[row * stride + game]);
+            Lanes boardRowBelow = loadLanes(&boardRows[(row + 1) * stride + game]);
+            collision = orLanes(collision, andLanes(blockRow, boardRowBelow));
+        }
+
+        Lanes canFall = equalLanes(collision, zero);
+        Lanes isFalling = andLanes(isActive, canFall);
+        Lanes isLocking = andNotLanes(canFall, isActive);
+
+        // moving the falling blocks one row down, from the bottom so every row is read before it's overwritten.
+        for (int row = TOTAL_ROWS - 1; row > 0; row--)
+        {
+            Lanes blockRow = loadLanes(&blockRows[row * stride + game]);
+            Lanes blockRowAbove = loadLanes(&blockRows[(row - 1) * stride + game]);
+            storeLanes(&blockRows[row * stride + game], selectLanes(isFalling, blockRowAbove, blockRow));
+        }
+
+        storeLanes(&blockRows[game], andNotLanes(isFalling, loadLanes(&blockRows[game])));
+
+        // the falling mask is all ones (-1) in the lanes that moved.
+        storeLanes(&batch.rowOffsets[game], subtractLanes(loadLanes(&batch.rowOffsets[game]), isFalling));
+
+        // and the locking blocks are written into their boards.
+        Lanes hasFullRow = zero;
+
+        for (int row = 0; row < TOTAL_ROWS; row++)
+        {
+            Lanes blockRow = loadLanes(&blockRows[row * stride + game]);
+            Lanes boardRow = orLanes(loadLanes(&boardRows[row * stride + game]), andLanes(isLocking, blockRow));
+
+            storeLanes(&boardRows[row * stride + game], boardRow);
+            storeLanes(&blockRows[row * stride + game], andNotLanes(isLocking, blockRow));
+
+            hasFullRow = orLanes(hasFullRow, equalLanes(boardRow, fullRow));
+        }
+
+        hasFullRow = andLanes(hasFullRow, isLocking);
+
+        int word = game / GAMES_PER_WORD;
+        int shift = game % GAMES_PER_WORD;
+
+        batch.lockedGames[word] |= laneBits(isLocking) << shift;
+        batch.fullRowGames[word] |= laneBits(hasFullRow) << shift;
+    }
+
+    // only a few games lock on each tick, those are finished one by one.
+    for (int word = 0; word < stride / GAMES_PER_WORD; word++)
+    {
+        uint32_t lockedGames = batch.lockedGames[word];
+
+        while (lockedGames != 0)
+        {
+            int bit = __builtin_ctz(lockedGames);
+            lockedGames &= lockedGames - 1;
+
+            finishBatchLock(batch, word * GAMES_PER_WORD + bit, (batch.fullRowGames[word] >> bit) & 1);
+        }
+    }
+}
@@ -0,0 +1,252 @@
+#include "beam_search.h"
+#include "collision.h"
+#include "zobrist.h"
+#include "trace.h"
+#include <algorithm>
+#include <chrono>
+#include <string.h>
+#include <vector>
+
+typedef struct
+{
+    uint16_t rows[TOTAL_ROWS];
+    uint64_t hash;
+    int firstPlacement;
+    int clearedRows;
+} SearchNode;
+
+// a child only keeps the block that was placed, the rows are built again for the ones that stay in the beam.
+typedef struct
+{
+    Block block;
+    uint64_t hash;
+    int parent;
+    int firstPlacement;
+    int clearedRows;
+    float value;
+} SearchChild;
+
+typedef struct
+{
+    const BotWeights *weights;
+    TranspositionTable *table;
+    Block block;
+    bool isFirstPly;
+    std::chrono::steady_clock::time_point deadline;
+    bool hasDeadline;
+    int totalNodes;
+    SearchNode nodes[MAX_BEAM_WIDTH];
+    // every node writes its children in its own MAX_PLACEMENTS slots, so the tasks never share an entry.
+    SearchChild *children;
+    int totalChildren[MAX_BEAM_WIDTH];
+    bool isExpanded[MAX_BEAM_WIDTH];
+} SearchPly;
+
+uint64_t getPlacedBlockHash(uint64_t hash, const Block &block)
+{
+    CellOffset blockCells[CELLS_PER_BLOCK];
+    getCellPositions(block, blockCells);
+
+    for (CellOffset blockCell : blockCells)
+    {
+        hash ^= getCellHash(blockCell.row, blockCell.column);
+    }
+
+    return hash;
+}
+
+void expandNode(void *data, int taskIndex, int workerIndex)
+{
+    TRACE_ZONE("expandNode");
+
+    SearchPly *ply = (SearchPly *)data;
+    const SearchNode &node = ply->nodes[taskIndex];
+
+    ply->totalChildren[taskIndex] = 0;
+    ply->isExpanded[taskIndex] = false;
+
+    if (ply->hasDeadline && std::chrono::steady_clock::now() > ply->deadline)
+    {
+        return;
+    }
+
+    // only the rows, they are all generatePlacements reads.
+    Board board = {};
+    memcpy(board.rows, node.rows, sizeof(board.rows));
+
+    PlacementList placements;
+    generatePlacements(board, ply->block, placements);
+
+    SearchChild *children = ply->children + taskIndex * MAX_PLACEMENTS;
+
+    for (int i = 0; i < placements.totalPlacements; i++)
+    {
+        uint16_t rows[TOTAL_ROWS];
+        memcpy(rows, node.rows, sizeof(rows));
+
+        SearchChild &child = children[i];
+        child.block = placements.placements[i].block;
+        child.parent = taskIndex;
+        child.firstPlacement = ply->isFirstPly ? i : node.firstPlacement;
+
+        int clearedRows = placeBlock(rows, child.block);
+        child.clearedRows = node.clearedRows + clearedRows;
+        child.hash = clearedRows > 0 ? getBoardHash(rows) : getPlacedBlockHash(node.hash, child.block);
+
+        // the evaluation is linear, so the part of the board can be cached and the cleared rows added after.
+        float boardValue = 0;
+
+        if (ply->table == nullptr || !probeTranspositionTable(*ply->table, child.hash, boardValue))
+        {
+            BoardFeatures features;
+            getBoardFeatures(rows, 0, features);
+
+            boardValue = evaluateBoard(features, *ply->weights);
+
+            if (ply->table != nullptr)
+            {
+                storeTranspositionTable(*ply->table, child.hash, boardValue);
+            }
+        }
+
+        child.value = boardValue + child.clearedRows * ply->weights->clearedRows;
+    }
+
+    ply->totalChildren[taskIndex] = placements.totalPlacements;
+    ply->isExpanded[taskIndex] = true;
+}
+
+bool isBetterChild(const SearchChild &child, const SearchChild &otherChild)
+{
+    if (child.value != otherChild.value)
+    {
+        return child.value > otherChild.value;
+    }
+
+    // the same order for the ties on every run, whatever the number of threads.
+    if (child.parent != otherChild.parent)
+    {
+        return child.parent < otherChild.parent;
+    }
+
+    return child.firstPlacement < otherChild.firstPlacement;
+}
+
+bool findBeamPlacement(const Board &board, const Block &block, const PieceQueue &queue, const SearchConfig &config, const BotWeights &weights, Placement &bestPlacement)
+{
+    int depth = std::min(config.depth, std::min(1 + (int)queue.depth, MAX_SEARCH_DEPTH));
+    int beamWidth = std::max(1, std::min(config.beamWidth, MAX_BEAM_WIDTH));
+
+    static thread_local SearchPly ply;
+    static thread_local std::vector<SearchChild> children(MAX_BEAM_WIDTH * MAX_PLACEMENTS);
+    static thread_local std::vector<SearchChild> ranking;
+
+    ply.weights = &weights;
+    ply.table = config.table;
+    ply.children = children.data();
+    ply.hasDeadline = config.timeBudget > 0;
+    ply.deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(config.timeBudget));
+
+    ply.totalNodes = 1;
+    memcpy(ply.nodes[0].rows, board.rows, sizeof(board.rows));
+    ply.nodes[0].hash = getBoardHash(board.rows);
+    ply.nodes[0].firstPlacement = -1;
+    ply.nodes[0].clearedRows = 0;
+
+    int bestFirstPlacement = -1;
+
+    for (int plyIndex = 0; plyIndex < depth; plyIndex++)
+    {
+        ply.block = plyIndex == 0 ? block : createBlock(peekPiece(queue, plyIndex - 1));
+        ply.isFirstPly = plyIndex == 0;
+
+        // the first placement is always searched, even when the time budget is already gone.
+        bool hasDeadline = ply.hasDeadline;
+        ply.hasDeadline = hasDeadline && plyIndex > 0;
+
+        if (config.pool != nullptr && ply.totalNodes > 1)
+        {
+            for (int i = 0; i < ply.totalNodes; i++)
+            {
+                submitTask(*config.pool, expandNode, &ply, i);
+            }
+
+            waitForTasks(*config.pool);
+        }
+        else
+        {
+            for (int i = 0; i < ply.totalNodes; i++)
+            {
+                expandNode(&ply, i, 0);
+            }
+        }
+
+        ply.hasDeadline = hasDeadline;
+
+        ranking.clear();
+        bool isComplete = true;
+
+        for (int i = 0; i < ply.totalNodes; i++)
+        {
+            isComplete = isComplete && ply.isExpanded[i];
+            ranking.insert(ranking.end(), ply.children + i * MAX_PLACEMENTS, ply.children + i * MAX_PLACEMENTS + ply.totalChildren[i]);
+        }
+
+        // a ply cut by the time budget only saw some of the boards, so it doesn't decide anything.
+        if (!isComplete || ranking.empty())
+        {
+            break;
+        }
+
+        // the duplicates are rare, twice the beam is almost always enough to fill it.
+        int totalSorted = std::min((int)ranking.size(), 2 * beamWidth);
+        std::partial_sort(ranking.begin(), ranking.begin() + totalSorted, ranking.end(), isBetterChild);
+
+        bestFirstPlacement = ranking[0].firstPlacement;
+
+        SearchNode nextNodes[MAX_BEAM_WIDTH];
+        int totalKept = 0;
+
+        for (int i = 0; i < totalSorted && totalKept < beamWidth; i++)
+        {
+            const SearchChild &child = ranking[i];
+
+            // the same board reached by placing the blocks in another order, the best one is already in the beam.
+            bool isDuplicate = false;
+
+            for (int j = 0; j < totalKept && !isDuplicate; j++)
+            {
+                isDuplicate = nextNodes[j].hash == child.hash;
+            }
+
+            if (isDuplicate)
+            {
+                continue;
+            }
+
+            SearchNode &nextNode = nextNodes[totalKept];
+            memcpy(nextNode.rows, ply.nodes[child.parent].rows, sizeof(nextNode.rows));
+            placeBlock(nextNode.rows, child.block);
+            nextNode.hash = child.hash;
+            nextNode.firstPlacement = child.firstPlacement;
+            nextNode.clearedRows = child.clearedRows;
+            totalKept++;
+        }
+
+        memcpy(ply.nodes, nextNodes, totalKept * sizeof(SearchNode));
+        ply.totalNodes = totalKept;
+    }
+
+    if (bestFirstPlacement == -1)
+    {
+        return false;
+    }
+
+    // the placements of the first block come out in the same order every time, so the winner can be generated again.
+    PlacementList placements;
+    generatePlacements(board, block, placements);
+
+    bestPlacement = placements.placements[bestFirstPlacement];
+
+    return true;
+}
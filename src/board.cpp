@@ -0,0 +1,123 @@
+#include "board.h"
+#include "zobrist.h"
+
+void clearBoard(Board &board)
+{
+    for (int row = 0; row < TOTAL_ROWS; row++)
+    {
+        board.rows[row] = 0;
+        board.cellIds[row] = 0;
+    }
+
+    for (int column = 0; column < TOTAL_COLUMNS; column++)
+    {
+        board.columns[column] = 0;
+    }
+
+    board.hash = 0;
+}
+
+bool isCellEmpty(const Board &board, int row, int column)
+{
+    return (board.rows[row] & (1 << column)) == 0;
+}
+
+int getCellId(const Board &board, int row, int column)
+{
+    return (board.cellIds[row] >> (column * 4)) & 0xF;
+}
+
+void setCell(Board &board, int row, int column, int id)
+{
+    if (isCellEmpty(board, row, column))
+    {
+        board.hash ^= getCellHash(row, column);
+    }
+
+    board.rows[row] |= 1 << column;
+    board.columns[column] |= 1u << row;
+
+    uint64_t idShift = column * 4;
+    board.cellIds[row] = (board.cellIds[row] & ~((uint64_t)0xF << idShift)) | ((uint64_t)id << idShift);
+}
+
+bool isRowFull(const Board &board, int row)
+{
+    return board.rows[row] == FULL_ROW_MASK;
+}
+
+int clearFullRows(Board &board)
+{
+    // compacting the rows from the bottom, every row that is not full falls into the next free slot.
+    int targetRow = TOTAL_ROWS - 1;
+    uint32_t fullRows = 0;
+
+    for (int row = TOTAL_ROWS - 1; row >= 0; row--)
+    {
+        if (isRowFull(board, row))
+        {
+            board.hash ^= getRowHash(row, FULL_ROW_MASK);
+            fullRows |= 1u << row;
+            continue;
+        }
+
+        // only the rows that fall change their keys.
+        if (targetRow != row)
+        {
+            board.hash ^= getRowHash(row, board.rows[row]) ^ getRowHash(targetRow, board.rows[row]);
+        }
+
+        board.rows[targetRow] = board.rows[row];
+        board.cellIds[targetRow] = board.cellIds[row];
+        targetRow--;
+    }
+
+    int completedRows = targetRow + 1;
+
+    for (int row = targetRow; row >= 0; row--)
+    {
+        board.rows[row] = 0;
+        board.cellIds[row] = 0;
+    }
+
+    // from the top full row down, every full row leaves the columns and the rows above it fall one row.
+    while (fullRows != 0)
+    {
+        uint32_t rowsAbove = (fullRows & -fullRows) - 1;
+
+        for (int column = 0; column < TOTAL_COLUMNS; column++)
+        {
+            uint32_t cells = board.columns[column];
+            board.columns[column] = ((cells & rowsAbove) << 1) | (cells & ~((rowsAbove << 1) | 1));
+        }
+
+        fullRows &= fullRows - 1;
+    }
+
+    return completedRows;
+}
+
+int clearFullRows(uint16_t *rows, int rowStride)
+{
+    int targetRow = TOTAL_ROWS - 1;
+
+    for (int row = TOTAL_ROWS - 1; row >= 0; row--)
+    {
+        if (rows[row * rowStride] == FULL_ROW_MASK)
+        {
+            continue;
+        }
+
+        rows[targetRow * rowStride] = rows[row * rowStride];
+        targetRow--;
+    }
+
+    int completedRows = targetRow + 1;
+
+    for (int row = targetRow; row >= 0; row--)
+    {
+        rows[row * rowStride] = 0;
+    }
+
+    return completedRows;
+}
@@ -0,0 +1,191 @@
+#include "bot.h"
+#include "beam_search.h"
+#include "collision.h"
+#include <stdlib.h>
+#include <string.h>
+
+const BotWeights DEFAULT_BOT_WEIGHTS = {-0.5f, -4.0f, -0.2f, -0.5f, -1.0f, -1.5f, 1.0f};
+
+int placeBlock(uint16_t rows[TOTAL_ROWS], const Block &block)
+{
+    CellOffset blockCells[CELLS_PER_BLOCK];
+    getCellPositions(block, blockCells);
+
+    for (CellOffset blockCell : blockCells)
+    {
+        if (blockCell.row >= 0)
+        {
+            rows[blockCell.row] |= 1 << blockCell.column;
+        }
+    }
+
+    return clearFullRows(rows, 1);
+}
+
+// every feature is counted with a few mask operations per row, there is no loop over the cells.
+void getBoardFeatures(const uint16_t rows[TOTAL_ROWS], int clearedRows, BoardFeatures &features)
+{
+    int heights[TOTAL_COLUMNS] = {};
+    uint16_t covered = 0;
+
+    features = {};
+    features.clearedRows = clearedRows;
+
+    for (int row = 0; row < TOTAL_ROWS; row++)
+    {
+        uint16_t cells = rows[row];
+        uint16_t emptyCells = ~cells & FULL_ROW_MASK;
+
+        // the columns that get their first filled cell in this row.
+        uint16_t topCells = cells & ~covered;
+
+        while (topCells != 0)
+        {
+            heights[__builtin_ctz(topCells)] = TOTAL_ROWS - row;
+            topCells &= topCells - 1;
+        }
+
+        // open cells with filled cells or walls at both sides.
+        uint16_t leftFilled = (cells << 1) | 1;
+        uint16_t rightFilled = (cells >> 1) | (1 << (TOTAL_COLUMNS - 1));
+        features.wells += __builtin_popcount(emptyCells & ~covered & leftFilled & rightFilled);
+
+        features.holes += __builtin_popcount(emptyCells & covered);
+
+        covered |= cells;
+
+        // a column of height h is covered in h rows.
+        features.aggregateHeight += __builtin_popcount(covered);
+
+        uint32_t walledCells = ((uint32_t)cells << 1) | 1 | (1 << (TOTAL_COLUMNS + 1));
+        features.rowTransitions += __builtin_popcount((walledCells ^ (walledCells >> 1)) & ((1 << (TOTAL_COLUMNS + 1)) - 1));
+
+        if (row > 0)
+        {
+            features.columnTransitions += __builtin_popcount(cells ^ rows[row - 1]);
+        }
+    }
+
+    // the floor counts as filled.
+    features.columnTransitions += __builtin_popcount(~rows[TOTAL_ROWS - 1] & FULL_ROW_MASK);
+
+    for (int column = 0; column < TOTAL_COLUMNS - 1; column++)
+    {
+        features.bumpiness += abs(heights[column] - heights[column + 1]);
+    }
+}
+
+float evaluateBoard(const BoardFeatures &features, const BotWeights &weights)
+{
+    return features.aggregateHeight * weights.aggregateHeight +
+           features.holes * weights.holes +
+           features.bumpiness * weights.bumpiness +
+           features.wells * weights.wells +
+           features.rowTransitions * weights.rowTransitions +
+           features.columnTransitions * weights.columnTransitions +
+           features.clearedRows * weights.clearedRows;
+}
+
+bool findBestPlacement(const Board &board, const Block &block, const BotWeights &weights, Placement &bestPlacement)
+{
+    PlacementList placements;
+    generatePlacements(board, block, placements);
+
+    int bestIndex = -1;
+    float bestValue = 0;
+
+    for (int i = 0; i < placements.totalPlacements; i++)
+    {
+        uint16_t rows[TOTAL_ROWS];
+        memcpy(rows, board.rows, sizeof(rows));
+
+        int clearedRows = placeBlock(rows, placements.placements[i].block);
+
+        BoardFeatures features;
+        getBoardFeatures(rows, clearedRows, features);
+
+        float value = evaluateBoard(features, weights);
+
+        if (bestIndex == -1 || value > bestValue)
+        {
+            bestIndex = i;
+            bestValue = value;
+        }
+    }
+
+    if (bestIndex == -1)
+    {
+        return false;
+    }
+
+    bestPlacement = placements.placements[bestIndex];
+
+    return true;
+}
+
+void resetBot(Bot &bot)
+{
+    bot.nextAction = 0;
+    bot.plannedPieces = -1;
+    bot.hasPlan = false;
+}
+
+bool isSameBlock(const Block &block, const Block &otherBlock)
+{
+    return block.id == otherBlock.id && block.rotationState == otherBlock.rotationState && block.rowOffset == otherBlock.rowOffset && block.columnOffset == otherBlock.columnOffset;
+}
+
+Action getBotAction(Bot &bot, const GameState &state, const BotWeights &weights)
+{
+    const Block &block = state.currentBlock;
+
+    // a new block, or gravity moved this one while the bot was following the path.
+    if (!bot.hasPlan || bot.plannedPieces != state.totalPieces || !isSameBlock(block, bot.expectedBlock))
+    {
+        if (bot.search.depth > 1)
+        {
+            bot.hasPlan = findBeamPlacement(state.board, block, state.queue, bot.search, weights, bot.placement);
+        }
+        else
+        {
+            bot.hasPlan = findBestPlacement(state.board, block, weights, bot.placement);
+        }
+
+        bot.hasPlan = bot.hasPlan && findPlacementPath(state.board, block, bot.placement.block, bot.path);
+
+        bot.nextAction = 0;
+        bot.plannedPieces = state.totalPieces;
+    }
+
+    Action action = ACTION_DOWN;
+
+    if (bot.hasPlan && bot.nextAction < bot.path.length)
+    {
+        action = (Action)bot.path.actions[bot.nextAction];
+        bot.nextAction++;
+    }
+
+    bot.expectedBlock = block;
+
+    if (action == ACTION_LEFT)
+    {
+        bot.expectedBlock.columnOffset--;
+    }
+
+    else if (action == ACTION_RIGHT)
+    {
+        bot.expectedBlock.columnOffset++;
+    }
+
+    else if (action == ACTION_ROTATE)
+    {
+        bot.expectedBlock.rotationState = (block.rotationState + 1) % BLOCK_ROTATIONS[block.id];
+    }
+
+    else
+    {
+        bot.expectedBlock.rowOffset++;
+    }
+
+    return action;
+}
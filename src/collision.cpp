@@ -0,0 +1,157 @@
+#include "collision.h"
+
+// a block can be moved up to 3 columns to the left of the board when its first columns are empty.
+const int COLUMN_BIAS = 3;
+const int TOTAL_COLUMN_POSITIONS = TOTAL_COLUMNS + COLUMN_BIAS;
+
+typedef struct
+{
+    // range of offsets where all the cells of the rotation are inside the board.
+    int8_t minRow;
+    int8_t maxRow;
+    int8_t minColumn;
+    int8_t maxColumn;
+    // rows of the rotation that have at least one cell.
+    int8_t firstRow;
+    int8_t lastRow;
+    // columns of the rotation that have at least one cell, and the lowest cell row of each one (its bottom profile).
+    int8_t firstColumn;
+    int8_t lastColumn;
+    int8_t bottomRows[CELLS_PER_BLOCK];
+    // one mask per row of the rotation already shifted to every column where it can be placed.
+    uint16_t rowMasks[TOTAL_COLUMN_POSITIONS][CELLS_PER_BLOCK];
+} RotationMasks;
+
+typedef struct
+{
+    RotationMasks rotations[TOTAL_BLOCK_TYPES + 1][TOTAL_ROTATIONS];
+} PieceMasks;
+
+constexpr PieceMasks buildPieceMasks()
+{
+    PieceMasks masks = {};
+
+    for (int id = 1; id <= TOTAL_BLOCK_TYPES; id++)
+    {
+        for (int rotation = 0; rotation < BLOCK_ROTATIONS[id]; rotation++)
+        {
+            RotationMasks &rotationMasks = masks.rotations[id][rotation];
+            const CellOffset *cells = BLOCK_CELLS[id][rotation];
+
+            int minCellRow = cells[0].row;
+            int maxCellRow = cells[0].row;
+            int minCellColumn = cells[0].column;
+            int maxCellColumn = cells[0].column;
+
+            for (int i = 1; i < CELLS_PER_BLOCK; i++)
+            {
+                minCellRow = cells[i].row < minCellRow ? cells[i].row : minCellRow;
+                maxCellRow = cells[i].row > maxCellRow ? cells[i].row : maxCellRow;
+                minCellColumn = cells[i].column < minCellColumn ? cells[i].column : minCellColumn;
+                maxCellColumn = cells[i].column > maxCellColumn ? cells[i].column : maxCellColumn;
+            }
+
+            rotationMasks.minRow = -minCellRow;
+            rotationMasks.maxRow = TOTAL_ROWS - 1 - maxCellRow;
+            rotationMasks.minColumn = -minCellColumn;
+            rotationMasks.maxColumn = TOTAL_COLUMNS - 1 - maxCellColumn;
+            rotationMasks.firstRow = minCellRow;
+            rotationMasks.lastRow = maxCellRow;
+            rotationMasks.firstColumn = minCellColumn;
+            rotationMasks.lastColumn = maxCellColumn;
+
+            for (int i = 0; i < CELLS_PER_BLOCK; i++)
+            {
+                int8_t &bottomRow = rotationMasks.bottomRows[cells[i].column];
+                bottomRow = cells[i].row > bottomRow ? cells[i].row : bottomRow;
+            }
+
+            for (int column = rotationMasks.minColumn; column <= rotationMasks.maxColumn; column++)
+            {
+                for (int i = 0; i < CELLS_PER_BLOCK; i++)
+                {
+                    rotationMasks.rowMasks[column + COLUMN_BIAS][cells[i].row] |= 1 << (cells[i].column + column);
+                }
+            }
+        }
+    }
+
+    return masks;
+}
+
+constexpr PieceMasks PIECE_MASKS = buildPieceMasks();
+
+void getCellPositions(const Block &block, CellOffset cells[CELLS_PER_BLOCK])
+{
+    const CellOffset *blockTiles = BLOCK_CELLS[block.id][block.rotationState];
+
+    for (int i = 0; i < CELLS_PER_BLOCK; i++)
+    {
+        cells[i].row = blockTiles[i].row + block.rowOffset;
+        cells[i].column = blockTiles[i].column + block.columnOffset;
+    }
+}
+
+bool pieceFits(const Board &board, int id, int rotation, int row, int column)
+{
+    return pieceFits(board.rows, 1, id, rotation, row, column);
+}
+
+bool pieceFits(const uint16_t *rows, int rowStride, int id, int rotation, int row, int column)
+{
+    const RotationMasks &rotationMasks = PIECE_MASKS.rotations[id][rotation];
+
+    if (row < rotationMasks.minRow || row > rotationMasks.maxRow || column < rotationMasks.minColumn || column > rotationMasks.maxColumn)
+    {
+        return false;
+    }
+
+    const uint16_t *rowMasks = rotationMasks.rowMasks[column + COLUMN_BIAS];
+
+    for (int cellRow = rotationMasks.firstRow; cellRow <= rotationMasks.lastRow; cellRow++)
+    {
+        if (rows[(row + cellRow) * rowStride] & rowMasks[cellRow])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool blockFits(const Board &board, const Block &block)
+{
+    return pieceFits(board, block.id, block.rotationState, block.rowOffset, block.columnOffset);
+}
+
+int findLandingRow(const Board &board, int id, int rotation, int row, int column)
+{
+    const RotationMasks &rotationMasks = PIECE_MASKS.rotations[id][rotation];
+
+    if (row < rotationMasks.minRow || row > rotationMasks.maxRow || column < rotationMasks.minColumn || column > rotationMasks.maxColumn)
+    {
+        return row;
+    }
+
+    int landingRow = rotationMasks.maxRow;
+
+    // every column of the block stops right above the first filled cell under its lowest cell.
+    for (int cellColumn = rotationMasks.firstColumn; cellColumn <= rotationMasks.lastColumn; cellColumn++)
+    {
+        int bottomRow = row + rotationMasks.bottomRows[cellColumn];
+        uint32_t cellsBelow = board.columns[column + cellColumn] & ~((2u << bottomRow) - 1);
+
+        if (cellsBelow != 0)
+        {
+            int columnLandingRow = row + __builtin_ctz(cellsBelow) - bottomRow - 1;
+            landingRow = columnLandingRow < landingRow ? columnLandingRow : landingRow;
+        }
+    }
+
+    return landingRow;
+}
+
+int findLandingRow(const Board &board, const Block &block)
+{
+    return findLandingRow(board, block.id, block.rotationState, block.rowOffset, block.columnOffset);
+}
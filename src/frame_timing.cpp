@@ -0,0 +1,138 @@
+#include "frame_timing.h"
+#include <algorithm>
+
+const char *PHASE_NAMES[TOTAL_FRAME_PHASES] = {"controller", "events", "update", "sounds", "render", "frame cap", "frame"};
+
+void resetFrameTimer(FrameTimer &timer, uint64_t frequency)
+{
+    for (int phase = 0; phase < TOTAL_FRAME_PHASES; phase++)
+    {
+        timer.maxSamples[phase] = 0;
+
+        for (int i = 0; i < FRAME_SAMPLES; i++)
+        {
+            timer.samples[phase][i] = 0;
+        }
+
+        for (int i = 0; i < HISTOGRAM_BUCKETS; i++)
+        {
+            timer.histogram[phase][i] = 0;
+        }
+    }
+
+    timer.frequency = frequency;
+    timer.totalFrames = 0;
+    timer.nextSample = 0;
+    timer.totalSamples = 0;
+}
+
+// below 64 us one bucket per microsecond, above it the top 6 bits of the time.
+int getHistogramBucket(uint64_t microseconds)
+{
+    if (microseconds < 64)
+    {
+        return (int)microseconds;
+    }
+
+    int exponent = 63 - __builtin_clzll(microseconds) - 5;
+
+    return std::min(exponent * 32 + (int)(microseconds >> exponent), HISTOGRAM_BUCKETS - 1);
+}
+
+// the middle of the times that fall in the bucket.
+double getBucketMicroseconds(int bucket)
+{
+    if (bucket < 64)
+    {
+        return bucket;
+    }
+
+    int exponent = bucket / 32 - 1;
+    uint64_t first = (uint64_t)(bucket % 32 + 32) << exponent;
+
+    return first + ((1ull << exponent) - 1) / 2.0;
+}
+
+uint64_t markPhase(FrameTimer &timer, FramePhase phase, uint64_t start, uint64_t now)
+{
+    uint64_t sample = now - start;
+
+    timer.samples[phase][timer.nextSample] = sample;
+    timer.maxSamples[phase] = std::max(timer.maxSamples[phase], sample);
+    timer.histogram[phase][getHistogramBucket(sample * 1000000 / timer.frequency)]++;
+
+    return now;
+}
+
+void endFrame(FrameTimer &timer)
+{
+    timer.nextSample = (timer.nextSample + 1) % FRAME_SAMPLES;
+    timer.totalSamples = std::min(timer.totalSamples + 1, FRAME_SAMPLES);
+    timer.totalFrames++;
+}
+
+double toMilliseconds(const FrameTimer &timer, uint64_t ticks)
+{
+    return ticks * 1000.0 / timer.frequency;
+}
+
+// the same rank as in the sorted samples, found walking the buckets.
+double getHistogramPercentile(const FrameTimer &timer, int phase, int percentile)
+{
+    uint64_t rank = (timer.totalFrames - 1) * percentile / 100;
+    uint64_t totalCounted = 0;
+
+    for (int bucket = 0; bucket < HISTOGRAM_BUCKETS; bucket++)
+    {
+        totalCounted += timer.histogram[phase][bucket];
+
+        if (totalCounted > rank)
+        {
+            return getBucketMicroseconds(bucket) / 1000.0;
+        }
+    }
+
+    return toMilliseconds(timer, timer.maxSamples[phase]);
+}
+
+void printFrameTimings(const FrameTimer &timer, FILE *file)
+{
+    if (timer.totalSamples == 0)
+    {
+        return;
+    }
+
+    fprintf(file, "frame timings over the last %d frames (ms):\n", timer.totalSamples);
+    fprintf(file, "%-12s %8s %8s %8s %8s\n", "phase", "p50", "p95", "p99", "max");
+
+    uint64_t sortedSamples[FRAME_SAMPLES];
+
+    for (int phase = 0; phase < TOTAL_FRAME_PHASES; phase++)
+    {
+        // the buffer is only full after FRAME_SAMPLES frames, until then the samples start at 0.
+        std::copy(timer.samples[phase], timer.samples[phase] + timer.totalSamples, sortedSamples);
+        std::sort(sortedSamples, sortedSamples + timer.totalSamples);
+
+        int last = timer.totalSamples - 1;
+
+        fprintf(file, "%-12s %8.3f %8.3f %8.3f %8.3f\n", PHASE_NAMES[phase],
+                toMilliseconds(timer, sortedSamples[last * 50 / 100]),
+                toMilliseconds(timer, sortedSamples[last * 95 / 100]),
+                toMilliseconds(timer, sortedSamples[last * 99 / 100]),
+                toMilliseconds(timer, sortedSamples[last]));
+    }
+
+    fprintf(file, "frame timings over all the %llu frames (ms):\n", (unsigned long long)timer.totalFrames);
+    fprintf(file, "%-12s %8s %8s %8s %8s\n", "phase", "p50", "p95", "p99", "max");
+
+    for (int phase = 0; phase < TOTAL_FRAME_PHASES; phase++)
+    {
+        fprintf(file, "%-12s %8.3f %8.3f %8.3f %8.3f\n", PHASE_NAMES[phase],
+                getHistogramPercentile(timer, phase, 50),
+                getHistogramPercentile(timer, phase, 95),
+                getHistogramPercentile(timer, phase, 99),
+                toMilliseconds(timer, timer.maxSamples[phase]));
+    }
+
+    fflush(file);
+}
@@ -0,0 +1,287 @@
+#include "game_state.h"
+#include "collision.h"
+#include "move_generator.h"
+#include "zobrist.h"
+#include "trace.h"
+
+void pushEvent(GameState &state, GameEvent event)
+{
+    if (state.totalEvents < MAX_GAME_EVENTS)
+    {
+        state.events[state.totalEvents] = event;
+        state.totalEvents++;
+    }
+}
+
+int getClearScore(int totalClearRows)
+{
+    if (totalClearRows == 1)
+    {
+        return 100;
+    }
+
+    else if (totalClearRows == 2)
+    {
+        return 300;
+    }
+
+    else if (totalClearRows > 2)
+    {
+        return 500;
+    }
+
+    return 0;
+}
+
+void resetGame(GameState &state, uint64_t seed)
+{
+    // the queue starts empty on every game, so the whole piece sequence comes from the seed.
+    state.seed = seed;
+    seedRandom(state.random, seed);
+    resetPieceQueue(state.queue, state.random, state.queue.depth);
+
+    clearBoard(state.board);
+    state.isGameOver = false;
+    state.isGamePaused = false;
+    state.score = 0;
+    state.totalLines = 0;
+    state.totalPieces = 0;
+    state.gravityTicks = 0;
+    state.totalTicks = 0;
+    state.totalEvents = 0;
+    state.dirtyRows = ALL_ROWS_DIRTY;
+    state.currentBlock = createBlock(takePiece(state.queue, state.random));
+}
+
+void clearEvents(GameState &state)
+{
+    state.totalEvents = 0;
+}
+
+void togglePause(GameState &state)
+{
+    state.isGamePaused = !state.isGamePaused;
+    pushEvent(state, GAME_PAUSED);
+}
+
+bool moveBlock(GameState &state, int rowsToMove, int columnsToMove)
+{
+    Block &block = state.currentBlock;
+
+    if (!pieceFits(state.board, block.id, block.rotationState, block.rowOffset + rowsToMove, block.columnOffset + columnsToMove))
+    {
+        return false;
+    }
+
+    block.rowOffset += rowsToMove;
+    block.columnOffset += columnsToMove;
+
+    return true;
+}
+
+void rotateBlock(GameState &state)
+{
+    Block &block = state.currentBlock;
+
+    int nextRotation = block.rotationState + 1;
+
+    if (nextRotation == BLOCK_ROTATIONS[block.id])
+    {
+        nextRotation = 0;
+    }
+
+    if (pieceFits(state.board, block.id, nextRotation, block.rowOffset, block.columnOffset))
+    {
+        block.rotationState = nextRotation;
+    }
+
+    // the rotate sound is played even when the rotation doesn't fit, as feedback for the key press.
+    pushEvent(state, BLOCK_ROTATED);
+}
+
+int clearFullRow(GameState &state)
+{
+    TRACE_ZONE("clearFullRow");
+
+    int completedRow = clearFullRows(state.board);
+
+    for (int i = 0; i < completedRow; i++)
+    {
+        pushEvent(state, ROW_CLEARED);
+    }
+
+    return completedRow;
+}
+
+void lockBlock(GameState &state)
+{
+    TRACE_ZONE("lockBlock");
+
+    CellOffset blockCells[CELLS_PER_BLOCK];
+    getCellPositions(state.currentBlock, blockCells);
+
+    int lowestRow = 0;
+
+    // I need to write in the grid the id of the block that I'm going to lock
+    for (CellOffset blockCell : blockCells)
+    {
+        setCell(state.board, blockCell.row, blockCell.column, state.currentBlock.id);
+        state.dirtyRows |= 1 << blockCell.row;
+        lowestRow = blockCell.row > lowestRow ? blockCell.row : lowestRow;
+    }
+
+    state.totalPieces++;
+    pushEvent(state, BLOCK_LOCKED);
+
+    // and then update the current and next blocks.
+    state.currentBlock = createBlock(takePiece(state.queue, state.random));
+
+    if (!blockFits(state.board, state.currentBlock))
+    {
+        state.isGameOver = true;
+        pushEvent(state, GAME_OVER);
+    }
+
+    int totalClearRows = clearFullRow(state);
+
+    // the full rows can only be rows of the block, everything above its lowest row falls.
+    if (totalClearRows > 0)
+    {
+        state.dirtyRows |= (2u << lowestRow) - 1;
+    }
+
+    state.totalLines += totalClearRows;
+    state.score += getClearScore(totalClearRows);
+}
+
+void moveBlockDown(GameState &state)
+{
+    Block &block = state.currentBlock;
+
+    if (pieceFits(state.board, block.id, block.rotationState, block.rowOffset + 1, block.columnOffset))
+    {
+        block.rowOffset++;
+    }
+    else
+    {
+        lockBlock(state);
+    }
+}
+
+void softDrop(GameState &state)
+{
+    if (state.isGameOver)
+    {
+        return;
+    }
+
+    state.score++;
+    moveBlockDown(state);
+}
+
+void shiftToWall(GameState &state, int direction)
+{
+    Block &block = state.currentBlock;
+    uint32_t fits = getFittingColumns(state.board, block.id, block.rotationState, block.rowOffset);
+    int bit = block.columnOffset + MOVE_COLUMN_BIAS;
+
+    if (direction > 0)
+    {
+        block.columnOffset += __builtin_ctz(~(fits >> bit)) - 1;
+    }
+    else
+    {
+        uint32_t blocked = ~fits & ((1u << bit) - 1);
+        int wallBit = blocked == 0 ? 0 : 32 - __builtin_clz(blocked);
+
+        block.columnOffset -= bit - wallBit;
+    }
+}
+
+void tickGame(GameState &state)
+{
+    if (state.isGameOver)
+    {
+        return;
+    }
+
+    moveBlockDown(state);
+}
+
+void applyAction(GameState &state, Action action)
+{
+    if (state.isGameOver)
+    {
+        return;
+    }
+
+    if (action == ACTION_LEFT)
+    {
+        moveBlock(state, 0, -1);
+    }
+
+    else if (action == ACTION_RIGHT)
+    {
+        moveBlock(state, 0, 1);
+    }
+
+    else if (action == ACTION_ROTATE)
+    {
+        rotateBlock(state);
+    }
+
+    else if (action == ACTION_DOWN)
+    {
+        softDrop(state);
+    }
+
+    else if (action == ACTION_LEFT_WALL)
+    {
+        shiftToWall(state, -1);
+    }
+
+    else if (action == ACTION_RIGHT_WALL)
+    {
+        shiftToWall(state, 1);
+    }
+}
+
+uint64_t getGameHash(const GameState &state)
+{
+    return state.board.hash ^ getBlockHash(state.currentBlock) ^ getPreviewHash(state.queue);
+}
+
+void updateGame(GameState &state)
+{
+    if (state.isGameOver)
+    {
+        return;
+    }
+
+    state.gravityTicks++;
+    state.totalTicks++;
+
+    if (state.gravityTicks == GRAVITY_TICKS)
+    {
+        state.gravityTicks = 0;
+        tickGame(state);
+    }
+}
+
+void updateGameUntil(GameState &state, uint64_t tick)
+{
+    while (!state.isGameOver && state.totalTicks < tick)
+    {
+        uint64_t ticksToGravity = GRAVITY_TICKS - state.gravityTicks;
+        uint64_t ticks = tick - state.totalTicks < ticksToGravity ? tick - state.totalTicks : ticksToGravity;
+
+        state.gravityTicks += (int)ticks;
+        state.totalTicks += ticks;
+
+        if (state.gravityTicks == GRAVITY_TICKS)
+        {
+            state.gravityTicks = 0;
+            tickGame(state);
+        }
+    }
+}
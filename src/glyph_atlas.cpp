@@ -0,0 +1,138 @@
+#include "glyph_atlas.h"
+#include "trace.h"
+
+bool createGlyphAtlas(GlyphAtlas &atlas, TTF_Font *font, SDL_Renderer *renderer)
+{
+    TRACE_ZONE("createGlyphAtlas");
+
+    atlas.texture = nullptr;
+    atlas.height = 0;
+
+    if (font == nullptr)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Unable to create the glyph atlas without a font! TTF Error: %s\n", TTF_GetError());
+        return false;
+    }
+
+    SDL_Color white = {255, 255, 255, 255};
+    SDL_Surface *glyphSurfaces[TOTAL_ATLAS_GLYPHS] = {};
+
+    // the glyphs are placed in rows from left to right, first only to know how tall the atlas needs to be.
+    int positionX = 0;
+    int positionY = 0;
+    int rowHeight = 0;
+
+    for (int i = 0; i < TOTAL_ATLAS_GLYPHS; i++)
+    {
+        Uint16 character = FIRST_ATLAS_GLYPH + i;
+        AtlasGlyph &glyph = atlas.glyphs[i];
+
+        int minX, maxX, minY, maxY;
+        TTF_GlyphMetrics(font, character, &minX, &maxX, &minY, &maxY, &glyph.advance);
+
+        glyphSurfaces[i] = TTF_RenderGlyph_Blended(font, character, white);
+
+        int width = glyphSurfaces[i] != nullptr ? glyphSurfaces[i]->w : 0;
+        int height = glyphSurfaces[i] != nullptr ? glyphSurfaces[i]->h : 0;
+
+        if (positionX + width > ATLAS_WIDTH)
+        {
+            positionX = 0;
+            positionY += rowHeight;
+            rowHeight = 0;
+        }
+
+        glyph.bounds = {positionX, positionY, width, height};
+
+        positionX += width;
+        rowHeight = height > rowHeight ? height : rowHeight;
+        atlas.height = height > atlas.height ? height : atlas.height;
+    }
+
+    int atlasHeight = positionY + rowHeight;
+    SDL_Surface *atlasSurface = SDL_CreateRGBSurfaceWithFormat(0, ATLAS_WIDTH, atlasHeight > 0 ? atlasHeight : 1, 32, SDL_PIXELFORMAT_RGBA32);
+
+    if (atlasSurface == nullptr)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Unable to create the glyph atlas surface! SDL Error: %s\n", SDL_GetError());
+
+        for (int i = 0; i < TOTAL_ATLAS_GLYPHS; i++)
+        {
+            SDL_FreeSurface(glyphSurfaces[i]);
+        }
+
+        return false;
+    }
+
+    for (int i = 0; i < TOTAL_ATLAS_GLYPHS; i++)
+    {
+        AtlasGlyph &glyph = atlas.glyphs[i];
+
+        glyph.textureRect = {(float)glyph.bounds.x / ATLAS_WIDTH, (float)glyph.bounds.y / atlasSurface->h, (float)glyph.bounds.w / ATLAS_WIDTH, (float)glyph.bounds.h / atlasSurface->h};
+
+        if (glyphSurfaces[i] != nullptr)
+        {
+            // copying the alpha of the glyph as it is, instead of blending it over the empty atlas.
+            SDL_SetSurfaceBlendMode(glyphSurfaces[i], SDL_BLENDMODE_NONE);
+            SDL_BlitSurface(glyphSurfaces[i], NULL, atlasSurface, &glyph.bounds);
+            SDL_FreeSurface(glyphSurfaces[i]);
+        }
+    }
+
+    atlas.texture = SDL_CreateTextureFromSurface(renderer, atlasSurface);
+    SDL_FreeSurface(atlasSurface);
+
+    if (atlas.texture == nullptr)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Unable to create the glyph atlas texture! SDL Error: %s\n", SDL_GetError());
+        return false;
+    }
+
+    SDL_SetTextureBlendMode(atlas.texture, SDL_BLENDMODE_BLEND);
+
+    return true;
+}
+
+void destroyGlyphAtlas(GlyphAtlas &atlas)
+{
+    SDL_DestroyTexture(atlas.texture);
+    atlas.texture = nullptr;
+}
+
+int getGlyphIndex(char character)
+{
+    if (character < FIRST_ATLAS_GLYPH || character > LAST_ATLAS_GLYPH)
+    {
+        return 0;
+    }
+
+    return character - FIRST_ATLAS_GLYPH;
+}
+
+int getTextWidth(const GlyphAtlas &atlas, const char *text)
+{
+    int width = 0;
+
+    for (const char *character = text; *character != '\0'; character++)
+    {
+        width += atlas.glyphs[getGlyphIndex(*character)].advance;
+    }
+
+    return width;
+}
+
+void addText(RectBatch &batch, const GlyphAtlas &atlas, const char *text, int positionX, int positionY, SDL_Color color)
+{
+    for (const char *character = text; *character != '\0'; character++)
+    {
+        const AtlasGlyph &glyph = atlas.glyphs[getGlyphIndex(*character)];
+
+        if (glyph.bounds.w > 0)
+        {
+            SDL_Rect rect = {positionX, positionY, glyph.bounds.w, glyph.bounds.h};
+            addTexturedRect(batch, rect, glyph.textureRect, color);
+        }
+
+        positionX += glyph.advance;
+    }
+}
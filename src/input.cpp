@@ -0,0 +1,187 @@
+#include "input.h"
+
+void resetInput(InputState &input, const InputConfig &config)
+{
+    input.config = config;
+    input.totalTransitions = 0;
+    input.shiftDirection = 0;
+
+    for (int button = 0; button < TOTAL_INPUT_BUTTONS; button++)
+    {
+        input.isHeld[button] = false;
+        input.heldTicks[button] = 0;
+    }
+}
+
+uint64_t getInputTick(uint32_t time, uint32_t frameStart, uint32_t frameEnd, uint64_t firstTick, int totalTicks)
+{
+    if (totalTicks == 0 || time <= frameStart || frameEnd <= frameStart)
+    {
+        return firstTick;
+    }
+
+    uint64_t index = (uint64_t)(time - frameStart) * totalTicks / (frameEnd - frameStart);
+
+    if (index >= (uint64_t)totalTicks)
+    {
+        index = totalTicks - 1;
+    }
+
+    return firstTick + index;
+}
+
+int getButtonDirection(int button)
+{
+    if (button == BUTTON_LEFT)
+    {
+        return -1;
+    }
+
+    if (button == BUTTON_RIGHT)
+    {
+        return 1;
+    }
+
+    return 0;
+}
+
+void holdButton(InputState &input, int button, bool isPressed)
+{
+    input.isHeld[button] = isPressed;
+    input.heldTicks[button] = 0;
+
+    int direction = getButtonDirection(button);
+
+    if (direction == 0)
+    {
+        return;
+    }
+
+    if (isPressed)
+    {
+        input.shiftDirection = direction;
+    }
+
+    // letting go of the active direction hands the shift to the other one, if it is still held, with a new delay.
+    else if (input.shiftDirection == direction)
+    {
+        int otherButton = direction < 0 ? BUTTON_RIGHT : BUTTON_LEFT;
+
+        input.shiftDirection = input.isHeld[otherButton] ? -direction : 0;
+        input.heldTicks[otherButton] = 0;
+    }
+}
+
+void settleInput(InputState &input)
+{
+    for (int i = 0; i < input.totalTransitions; i++)
+    {
+        if (input.transitions[i].isPressed != input.isHeld[input.transitions[i].button])
+        {
+            holdButton(input, input.transitions[i].button, input.transitions[i].isPressed);
+        }
+    }
+
+    input.totalTransitions = 0;
+}
+
+void pushInput(InputState &input, InputButton button, bool isPressed, uint64_t tick)
+{
+    // more transitions than ticks can take in one frame, the old ones only keep which buttons are held.
+    if (input.totalTransitions == MAX_INPUT_TRANSITIONS)
+    {
+        settleInput(input);
+    }
+
+    input.transitions[input.totalTransitions++] = {button, isPressed, tick};
+}
+
+Action getShiftAction(const InputState &input)
+{
+    int button = input.shiftDirection < 0 ? BUTTON_LEFT : BUTTON_RIGHT;
+
+    if (input.config.arrTicks == 0 && input.heldTicks[button] >= input.config.dasTicks)
+    {
+        return input.shiftDirection < 0 ? ACTION_LEFT_WALL : ACTION_RIGHT_WALL;
+    }
+
+    return input.shiftDirection < 0 ? ACTION_LEFT : ACTION_RIGHT;
+}
+
+int updateInput(InputState &input, uint64_t tick, Action actions[MAX_INPUT_ACTIONS])
+{
+    bool isPressedNow[TOTAL_INPUT_BUTTONS] = {};
+    int totalWaiting = 0;
+    int totalActions = 0;
+
+    for (int i = 0; i < input.totalTransitions; i++)
+    {
+        const InputTransition &transition = input.transitions[i];
+
+        if (transition.tick > tick)
+        {
+            input.transitions[totalWaiting++] = transition;
+            continue;
+        }
+
+        // the repeated presses of the operating system are not transitions.
+        if (transition.isPressed == input.isHeld[transition.button])
+        {
+            continue;
+        }
+
+        holdButton(input, transition.button, transition.isPressed);
+        isPressedNow[transition.button] = transition.isPressed;
+
+        if (!transition.isPressed)
+        {
+            continue;
+        }
+
+        if (transition.button == BUTTON_SOFT_DROP)
+        {
+            actions[totalActions++] = ACTION_DOWN;
+        }
+
+        else if (transition.button == BUTTON_ROTATE)
+        {
+            actions[totalActions++] = ACTION_ROTATE;
+        }
+
+        else
+        {
+            actions[totalActions++] = getShiftAction(input);
+        }
+    }
+
+    input.totalTransitions = totalWaiting;
+
+    if (input.shiftDirection != 0)
+    {
+        int button = input.shiftDirection < 0 ? BUTTON_LEFT : BUTTON_RIGHT;
+
+        if (!isPressedNow[button])
+        {
+            input.heldTicks[button]++;
+
+            int repeatTicks = input.heldTicks[button] - input.config.dasTicks;
+
+            if (repeatTicks >= 0 && (input.config.arrTicks == 0 || repeatTicks % input.config.arrTicks == 0))
+            {
+                actions[totalActions++] = getShiftAction(input);
+            }
+        }
+    }
+
+    if (input.isHeld[BUTTON_SOFT_DROP] && !isPressedNow[BUTTON_SOFT_DROP])
+    {
+        input.heldTicks[BUTTON_SOFT_DROP]++;
+
+        if (input.heldTicks[BUTTON_SOFT_DROP] % input.config.softDropTicks == 0)
+        {
+            actions[totalActions++] = ACTION_DOWN;
+        }
+    }
+
+    return totalActions;
+}
@@ -1,11 +1,18 @@
 #include "sdl_starter.h"
 #include "sdl_assets_loader.h"
-#include <vector>
-#include <string>
-#include <map>
-
-using std::vector;
-using std::map;
+#include "board.h"
+#include "collision.h"
+#include "game_state.h"
+#include "beam_search.h"
+#include "frame_timing.h"
+#include "sim_clock.h"
+#include "input.h"
+#include "replay.h"
+#include "trace.h"
+#include "glyph_atlas.h"
+#include <string.h>
+#include <stdlib.h>
+#include <algorithm>
 
 SDL_Window *window = nullptr;
 SDL_Renderer *renderer = nullptr;
@@ -16,576 +23,445 @@ Mix_Music *music = nullptr;
 
 TTF_Font *font = nullptr;
 
-SDL_Texture *pauseTexture = nullptr;
-SDL_Rect pauseBounds;
+// all the text is drawn from the glyphs of the font, rasterized once at startup.
+GlyphAtlas fontAtlas;
+RectBatch textBatch;
 
-const int TOTAL_ROWS = 18;
-const int TOTAL_COLUMNS = 10;
-const int CELL_SIZE = 30;
+const SDL_Point SCORE_LABEL_POSITION = {365, 15};
+const SDL_Point SCORE_POSITION = {365, 65};
+const SDL_Point NEXT_LABEL_POSITION = {370, 175};
+const SDL_Point PAUSE_POSITION = {330, 450};
 
-int grid[TOTAL_ROWS][TOTAL_COLUMNS];
+const int CELL_SIZE = 30;
 
 const int POSITION_OFFSET = 4;
 const int CELL_OFFSET = 2;
 
-bool isGamePaused;
-bool isGameOver;
+GameState game;
 
-int score;
+// the bot plays instead of the keyboard and the controller, toggled with the B key or started with --bot.
+const int BOT_ACTION_TICKS = 3;
 
-SDL_Texture *scoreTextTexture = nullptr;
-SDL_Rect scoreTextBounds;
+// the bot searches the next block too, using all the cores for at most a millisecond per block.
+const double BOT_TIME_BUDGET = 0.001;
 
-SDL_Texture *scoreTexture = nullptr;
-SDL_Rect scoreBounds;
+ThreadPool pool;
+TranspositionTable table;
+Bot bot;
+bool isBotPlaying = false;
+int botActionTicks = 0;
 
-SDL_Texture *nextTexture = nullptr;
-SDL_Rect nextBounds;
+// the game runs at TICKS_PER_SECOND whatever the frame rate is, every frame runs the ticks due since the last one.
+SimClock simClock;
 
-Mix_Chunk *rotateSound = nullptr;
-Mix_Chunk *clearRowSound = nullptr;
+// the moves and the soft drop of the player, stamped with the tick they happened in.
+InputState input;
 
-typedef struct Vector2
-{
-    float x; 
-    float y; 
-} Vector2;
-
-typedef struct
-{
-    int id;
-    map<int, vector<Vector2>> cells;
-    int rotationState;
-    int columnOffset;
-    int rowOffset;
-} Block;
-
-Block lBlock;
-Block jBlock;
-Block iBlock;
-Block oBlock;
-Block sBlock;
-Block tBlock;
-Block zBlock;
-Block currentBlock;
-Block nextBlock;
-
-vector<Block> blocks;
-
-vector<Vector2> getCellPositions(Block &block)
-{
-    // getting the reference of the vector instead of copying to create a new one.
-    vector<Vector2> &blockTiles = block.cells[block.rotationState];
+// the time of the events polled in this frame goes from lastPollTime to pollTime, they fall in the ticks of this frame.
+Uint32 lastPollTime = 0;
+Uint32 pollTime = 0;
+int frameTicks = 0;
 
-    vector<Vector2> movedTiles;
-    movedTiles.reserve(blockTiles.size());
+// while the game is paused, over, minimized or without focus the loop sleeps until the next event,
+// and only draws again when something changed.
+const Uint32 IDLE_WAIT_MILLISECONDS = 250;
+const int IDLE_MUSIC_VOLUME = MIX_MAX_VOLUME / 4;
 
-    for (Vector2 blockTile : blockTiles)
-    {
-        Vector2 newPosition = {blockTile.x + block.rowOffset, blockTile.y + block.columnOffset};
-        movedTiles.push_back(newPosition);
-    }
+bool isWindowMinimized = false;
+bool hasWindowFocus = true;
+bool wasIdle = false;
+bool needsRedraw = true;
 
-    return movedTiles;
-}
+// where the time of every frame goes, printed with F3 and when the game is closed.
+FrameTimer frameTimer;
 
-bool isCellOutside(int cellRow, int cellColumn)
-{
-    if (cellRow >= 0 && cellRow < TOTAL_ROWS && cellColumn >= 0 && cellColumn < TOTAL_COLUMNS)
-    {
-        return false;
-    }
+// the frames follow the refresh rate of the display, paced by the performance counter instead of vsync.
+FramePacer framePacer;
 
-    return true;
-}
+Mix_Chunk *rotateSound = nullptr;
+Mix_Chunk *clearRowSound = nullptr;
 
-bool isBlockOutside(Block &block)
-{
-    vector<Vector2> blockTiles = getCellPositions(block);
+const SDL_Color BACKGROUND_COLOR = {29, 29, 27, 255};
 
-    for (Vector2 blockTile : blockTiles)
-    {
-        if (isCellOutside(blockTile.x, blockTile.y))
-        {
-            return true;
-        }
-    }
+const SDL_Color lightGrey = {80, 80, 80, 255};
+const SDL_Color green = {47, 230, 23, 255};
+const SDL_Color red = {232, 18, 18, 255};
+const SDL_Color orange = {226, 116, 17, 255};
+const SDL_Color yellow = {237, 234, 4, 255};
+const SDL_Color purple = {166, 0, 247, 255};
+const SDL_Color cyan = {21, 204, 209, 255};
+const SDL_Color blue = {13, 64, 216, 255};
 
-    return false;
-}
+// indexed by the block id, 0 is an empty cell.
+const SDL_Color CELL_COLORS[TOTAL_BLOCK_TYPES + 1] = {lightGrey, green, red, orange, yellow, purple, cyan, blue};
 
-void undoRotation(Block &block)
-{
-    block.rotationState--;
+// every solid rect of the frame goes here and is drawn with a single call.
+RectBatch rectBatch;
 
-    if (block.rotationState == -1)
-    {
-        block.rotationState = block.cells.size() - 1;
-    }
-}
+// the locked cells, only the dirty rows of the game are drawn again. Without render targets the grid is drawn every frame.
+SDL_Texture *boardTexture = nullptr;
 
-bool isCellEmpty(int rowToCheck, int columnToCheck)
+void createBoardTexture()
 {
-    if (grid[rowToCheck][columnToCheck] == 0)
-    {
-        return true;
-    }
+    SDL_DestroyTexture(boardTexture);
+    boardTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, TOTAL_COLUMNS * CELL_SIZE, TOTAL_ROWS * CELL_SIZE);
 
-    return false;
-}
+    // every pixel is drawn opaque, so the copy doesn't need to blend.
+    SDL_SetTextureBlendMode(boardTexture, SDL_BLENDMODE_NONE);
 
-bool blockFits(Block &block)
-{
-    auto blockCells = getCellPositions(block);
-
-    // I need to write in the grid the id of the block that I'm going to lock
-    for (Vector2 blockCell : blockCells)
+    if (boardTexture == nullptr)
     {
-        if (!isCellEmpty(blockCell.x, blockCell.y))
-        {
-            return false;
-        }
+        SDL_Log("Unable to create the board texture, drawing the grid every frame. SDL Error: %s\n", SDL_GetError());
     }
 
-    return true;
+    game.dirtyRows = ALL_ROWS_DIRTY;
 }
 
-void rotateBlock(Block &block)
-{
-    block.rotationState++;
-
-    if (block.rotationState == (int)block.cells.size())
-    {
-        block.rotationState = 0;
-    }
+// every game is recorded, every action of the player or the bot goes through playAction,
+// and the replay is written when the game is over.
+const char *REPLAY_DIRECTORY = "replays";
 
-    if (isBlockOutside(block) || !blockFits(currentBlock))
-    {
-        undoRotation(block);
-    }
-}
+Replay replay;
 
-void moveBlock(Block &block, int rowsToMove, int columnsToMove)
+void startGame(uint64_t seed)
 {
-    block.rowOffset += rowsToMove;
-    block.columnOffset += columnsToMove;
+    resetGame(game, seed);
+    startReplay(replay, game);
+    settleInput(input);
 }
 
-int rand_range(int min, int max)
+void pauseGame()
 {
-    return min + rand() / (RAND_MAX / (max - min + 1) + 1);
+    togglePause(game);
+    settleInput(input);
 }
 
-Block getRandomBlock()
+void playAction(Action action)
 {
-    if (blocks.empty())
+    if (game.isGameOver)
     {
-        blocks = {lBlock, jBlock, iBlock, oBlock, sBlock, tBlock, zBlock};
+        return;
     }
 
-    int randomIndex = rand_range(0, blocks.size() - 1);
-
-    Block actualBlock = blocks[randomIndex];
-    blocks.erase(blocks.begin() + randomIndex);
-
-    return actualBlock;
+    recordAction(replay, game.totalTicks, action);
+    applyAction(game, action);
 }
 
-bool isRowFull(int rowToCheck)
+void saveFinishedGame()
 {
-    for (int column = 0; column < TOTAL_COLUMNS; column++)
+    if (game.isGameOver && !replay.isFinished && !saveReplay(replay, game, REPLAY_DIRECTORY))
     {
-        if (grid[rowToCheck][column] == 0)
-        {
-            return false;
-        }
+        SDL_Log("Unable to save the replay in %s!\n", REPLAY_DIRECTORY);
     }
-
-    return true;
 }
 
-void clearRow(int rowToClear)
+void pushButton(InputButton button, bool isPressed, Uint32 timestamp)
 {
-    for (int column = 0; column < TOTAL_COLUMNS; column++)
-    {
-        grid[rowToClear][column] = 0;
-    }
+    uint64_t tick = getInputTick(timestamp, lastPollTime, pollTime, simClock.totalTicks - frameTicks, frameTicks);
+    pushInput(input, button, isPressed, tick);
 }
 
-void moveRowDown(int row, int totalRows)
+void handleEvents()
 {
-    for (int column = 0; column < TOTAL_COLUMNS; column++)
-    {
-        grid[row + totalRows][column] = grid[row][column];
-        grid[row][column] = 0;
-    }
-}
+    TRACE_ZONE("handleEvents");
 
-int clearFullRow()
-{
-    int completedRow = 0;
-    for (int row = TOTAL_ROWS - 1; row >= 0; row--)
+    SDL_Event event;
+
+    while (SDL_PollEvent(&event))
     {
-        if (isRowFull(row))
+        if (event.type == SDL_QUIT || event.key.keysym.sym == SDLK_ESCAPE)
         {
-            clearRow(row);
-            completedRow++;
-            Mix_PlayChannel(-1, clearRowSound, 0);
+            printFrameTimings(frameTimer, stdout);
+            printFramePacer(framePacer, stdout);
+            stopThreadPool(pool);
+            TRACE_WRITE("trace.json");
+            exit(0);
         }
-        else if (completedRow > 0)
+
+        if (game.isGameOver && (event.type == SDL_KEYDOWN || event.type == SDL_CONTROLLERBUTTONDOWN))
         {
-            moveRowDown(row, completedRow);
+            startGame(nextRandom(game.random));
         }
-    }
-
-    return completedRow;
-}
-
-void lockBlock(Block &block)
-{
-    auto blockCells = getCellPositions(block);
-
-    // I need to write in the grid the id of the block that I'm going to lock
-    for (Vector2 blockCell : blockCells)
-    {
-        grid[(int)blockCell.x][(int)blockCell.y] = block.id;
-    }
-
-    // and then update the current and next blocks.
-    block = nextBlock;
-
-    if (!blockFits(block))
-    {
-        isGameOver = true;
-    }
-
-    nextBlock = getRandomBlock();
-
-    int totalClearRows = clearFullRow();
 
-    if (totalClearRows == 1)
-    {
-        score += 100;
-    }
-
-    else if (totalClearRows == 2)
-    {
-        score += 300;
-    }
+        // To handle key pressed more precise, I use this method for handling pause the game or jumping.
+        if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_SPACE)
+        {
+            pauseGame();
+        }
 
-    else if (totalClearRows > 2)
-    {
-        score += 500;
-    }
-}
+        if (event.type == SDL_CONTROLLERBUTTONDOWN && event.cbutton.button == SDL_CONTROLLER_BUTTON_START)
+        {
+            pauseGame();
+        }
 
-void initializeGrid()
-{
-    for (int row = 0; row < TOTAL_ROWS; row++)
-    {
-        for (int column = 0; column < TOTAL_COLUMNS; column++)
+        // the contents of the render targets are lost, and after a device reset the textures too.
+        if (event.type == SDL_RENDER_TARGETS_RESET)
         {
-            grid[row][column] = 0;
+            game.dirtyRows = ALL_ROWS_DIRTY;
+            needsRedraw = true;
         }
-    }
-}
 
-double lastUpdateTime = 0;
+        if (event.type == SDL_RENDER_DEVICE_RESET)
+        {
+            createBoardTexture();
+            needsRedraw = true;
 
-bool eventTriggered(float deltaTime, float intervalUpdate)
-{
-    lastUpdateTime += deltaTime;
+            destroyGlyphAtlas(fontAtlas);
+            createGlyphAtlas(fontAtlas, font, renderer);
+        }
 
-    if (lastUpdateTime >= intervalUpdate)
-    {
-        lastUpdateTime = 0;
+        if (event.type == SDL_WINDOWEVENT)
+        {
+            if (event.window.event == SDL_WINDOWEVENT_FOCUS_LOST)
+            {
+                hasWindowFocus = false;
+            }
 
-        return true;
-    }
+            else if (event.window.event == SDL_WINDOWEVENT_FOCUS_GAINED)
+            {
+                hasWindowFocus = true;
+            }
 
-    return false;
-}
+            else if (event.window.event == SDL_WINDOWEVENT_MINIMIZED)
+            {
+                isWindowMinimized = true;
+            }
 
-void handleEvents()
-{
-    SDL_Event event;
+            else if (event.window.event == SDL_WINDOWEVENT_RESTORED || event.window.event == SDL_WINDOWEVENT_MAXIMIZED)
+            {
+                isWindowMinimized = false;
+            }
 
-    while (SDL_PollEvent(&event))
-    {
-        if (event.type == SDL_QUIT || event.key.keysym.sym == SDLK_ESCAPE)
-        {
-            exit(0);
+            needsRedraw = true;
         }
 
-        if (isGameOver && (event.type == SDL_KEYDOWN || event.type == SDL_CONTROLLERBUTTONDOWN))
+        if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F3)
         {
-            initializeGrid();
-            isGameOver = false;
-            score = 0;
-            currentBlock = getRandomBlock();
-            nextBlock = getRandomBlock();
+            printFrameTimings(frameTimer, stdout);
+            printFramePacer(framePacer, stdout);
         }
 
-        // To handle key pressed more precise, I use this method for handling pause the game or jumping.
-        if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_SPACE)
+        if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_b)
         {
-            isGamePaused = !isGamePaused;
-            Mix_PlayChannel(-1, pauseSound, 0);
+            isBotPlaying = !isBotPlaying;
+            resetBot(bot);
+            resetInput(input, input.config);
         }
 
-        if (!isGameOver && event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_w)
+        if (isBotPlaying)
         {
-            rotateBlock(currentBlock);
-            Mix_PlayChannel(-1, rotateSound, 0);
+            continue;
         }
 
-        if (!isGameOver && event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_d)
+        // the held keys are handled in the ticks, the repeats of the operating system are ignored.
+        if ((event.type == SDL_KEYDOWN || event.type == SDL_KEYUP) && event.key.repeat == 0)
         {
-            moveBlock(currentBlock, 0, 1);
+            bool isPressed = event.type == SDL_KEYDOWN;
 
-            if (isBlockOutside(currentBlock) || !blockFits(currentBlock))
+            if (event.key.keysym.sym == SDLK_a)
             {
-                moveBlock(currentBlock, 0, -1);
+                pushButton(BUTTON_LEFT, isPressed, event.key.timestamp);
             }
-        }
 
-        else if (!isGameOver && event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_a)
-        {
-            moveBlock(currentBlock, 0, -1);
+            else if (event.key.keysym.sym == SDLK_d)
+            {
+                pushButton(BUTTON_RIGHT, isPressed, event.key.timestamp);
+            }
 
-            if (isBlockOutside(currentBlock) || !blockFits(currentBlock))
+            else if (event.key.keysym.sym == SDLK_s)
             {
-                moveBlock(currentBlock, 0, 1);
+                pushButton(BUTTON_SOFT_DROP, isPressed, event.key.timestamp);
             }
-        }
 
-        // controller support
-        if (event.type == SDL_CONTROLLERBUTTONDOWN && event.cbutton.button == SDL_CONTROLLER_BUTTON_START)
-        {
-            isGamePaused = !isGamePaused;
-            Mix_PlayChannel(-1, pauseSound, 0);
+            else if (event.key.keysym.sym == SDLK_w)
+            {
+                pushButton(BUTTON_ROTATE, isPressed, event.key.timestamp);
+            }
         }
 
-        if (event.type == SDL_CONTROLLERBUTTONDOWN && (event.cbutton.button == SDL_CONTROLLER_BUTTON_DPAD_UP || event.cbutton.button == SDL_CONTROLLER_BUTTON_A))
+        // controller support
+        if (event.type == SDL_CONTROLLERBUTTONDOWN || event.type == SDL_CONTROLLERBUTTONUP)
         {
-            rotateBlock(currentBlock);
-            Mix_PlayChannel(-1, rotateSound, 0);
-        }
+            bool isPressed = event.type == SDL_CONTROLLERBUTTONDOWN;
 
-        if (event.type == SDL_CONTROLLERBUTTONDOWN && event.cbutton.button == SDL_CONTROLLER_BUTTON_DPAD_RIGHT)
-        {
-            moveBlock(currentBlock, 0, 1);
+            if (event.cbutton.button == SDL_CONTROLLER_BUTTON_DPAD_LEFT)
+            {
+                pushButton(BUTTON_LEFT, isPressed, event.cbutton.timestamp);
+            }
 
-            if (isBlockOutside(currentBlock) || !blockFits(currentBlock))
+            else if (event.cbutton.button == SDL_CONTROLLER_BUTTON_DPAD_RIGHT)
             {
-                moveBlock(currentBlock, 0, -1);
+                pushButton(BUTTON_RIGHT, isPressed, event.cbutton.timestamp);
             }
-        }
 
-        else if (event.type == SDL_CONTROLLERBUTTONDOWN && event.cbutton.button == SDL_CONTROLLER_BUTTON_DPAD_LEFT)
-        {
-            moveBlock(currentBlock, 0, -1);
+            else if (event.cbutton.button == SDL_CONTROLLER_BUTTON_DPAD_DOWN)
+            {
+                pushButton(BUTTON_SOFT_DROP, isPressed, event.cbutton.timestamp);
+            }
 
-            if (isBlockOutside(currentBlock) || !blockFits(currentBlock))
+            else if (event.cbutton.button == SDL_CONTROLLER_BUTTON_DPAD_UP || event.cbutton.button == SDL_CONTROLLER_BUTTON_A)
             {
-                moveBlock(currentBlock, 0, 1);
+                pushButton(BUTTON_ROTATE, isPressed, event.cbutton.timestamp);
             }
         }
     }
 }
 
-void update(float deltaTime)
+// one game tick.
+void update(uint64_t tick)
 {
-    const Uint8 *currentKeyStates = SDL_GetKeyboardState(NULL);
+    TRACE_ZONE("update");
 
-    if (!isGameOver && currentKeyStates[SDL_SCANCODE_S])
+    if (isBotPlaying)
     {
-        score++;
-        moveBlock(currentBlock, 1, 0);
+        botActionTicks++;
 
-        if (isBlockOutside(currentBlock) || !blockFits(currentBlock))
+        if (botActionTicks == BOT_ACTION_TICKS)
         {
-            moveBlock(currentBlock, -1, 0);
-            lockBlock(currentBlock);
+            botActionTicks = 0;
+            playAction(getBotAction(bot, game, DEFAULT_BOT_WEIGHTS));
         }
+
+        updateGame(game);
+
+        return;
     }
 
-    if (!isGameOver && SDL_GameControllerGetButton(controller, SDL_CONTROLLER_BUTTON_DPAD_DOWN))
+    Action actions[MAX_INPUT_ACTIONS];
+    int totalActions = updateInput(input, tick, actions);
+
+    for (int i = 0; i < totalActions; i++)
     {
-        score++;
-        moveBlock(currentBlock, 1, 0);
+        playAction(actions[i]);
+    }
 
-        if (isBlockOutside(currentBlock) || !blockFits(currentBlock))
+    updateGame(game);
+}
+
+void playGameSounds()
+{
+    for (int i = 0; i < game.totalEvents; i++)
+    {
+        if (game.events[i] == BLOCK_ROTATED)
         {
-            moveBlock(currentBlock, -1, 0);
-            lockBlock(currentBlock);
+            Mix_PlayChannel(-1, rotateSound, 0);
         }
-    }
 
-    if (!isGameOver && eventTriggered(deltaTime, 0.5))
-    {
-        moveBlock(currentBlock, 1, 0);
+        else if (game.events[i] == ROW_CLEARED)
+        {
+            Mix_PlayChannel(-1, clearRowSound, 0);
+        }
 
-        if (isBlockOutside(currentBlock) || !blockFits(currentBlock))
+        else if (game.events[i] == GAME_PAUSED)
         {
-            moveBlock(currentBlock, -1, 0);
-            lockBlock(currentBlock);
+            Mix_PlayChannel(-1, pauseSound, 0);
         }
     }
-}
-
-void initializeBlocks()
-{
-    // defining Blocks 4 rotations with a map id and vector2 2
-    lBlock.id = 1;
-    lBlock.cells[0] = {{0, 2}, {1, 0}, {1, 1}, {1, 2}};
-    lBlock.cells[1] = {{0, 1}, {1, 1}, {2, 1}, {2, 2}};
-    lBlock.cells[2] = {{1, 0}, {1, 1}, {1, 2}, {2, 0}};
-    lBlock.cells[3] = {{0, 0}, {0, 1}, {1, 1}, {2, 1}};
-    // for all the block to start in the midle of the grid, I need to move to the (0, 3)
-    moveBlock(lBlock, 0, 3);
-
-    jBlock.id = 2;
-    jBlock.cells[0] = {{0, 0}, {1, 0}, {1, 1}, {1, 2}};
-    jBlock.cells[1] = {{0, 1}, {0, 2}, {1, 1}, {2, 1}};
-    jBlock.cells[2] = {{1, 0}, {1, 1}, {1, 2}, {2, 2}};
-    jBlock.cells[3] = {{0, 1}, {1, 1}, {2, 0}, {2, 1}};
-
-    moveBlock(jBlock, 0, 3);
-
-    iBlock.id = 3;
-    iBlock.cells[0] = {{1, 0}, {1, 1}, {1, 2}, {1, 3}};
-    iBlock.cells[1] = {{0, 2}, {1, 2}, {2, 2}, {3, 2}};
-    iBlock.cells[2] = {{2, 0}, {2, 1}, {2, 2}, {2, 3}};
-    iBlock.cells[3] = {{0, 1}, {1, 1}, {2, 1}, {3, 1}};
-
-    moveBlock(iBlock, -1, 3);
-
-    // I don't need rotaion with this block
-    oBlock.id = 4;
-    oBlock.cells[0] = {{0, 0}, {0, 1}, {1, 0}, {1, 1}};
-
-    moveBlock(oBlock, 0, 4);
-
-    sBlock.id = 5;
-    sBlock.cells[0] = {{0, 1}, {0, 2}, {1, 0}, {1, 1}};
-    sBlock.cells[1] = {{0, 1}, {1, 1}, {1, 2}, {2, 2}};
-    sBlock.cells[2] = {{1, 1}, {1, 2}, {2, 0}, {2, 1}};
-    sBlock.cells[3] = {{0, 0}, {1, 0}, {1, 1}, {2, 1}};
-
-    moveBlock(sBlock, 0, 3);
-
-    tBlock.id = 6;
-    tBlock.cells[0] = {{0, 1}, {1, 0}, {1, 1}, {1, 2}};
-    tBlock.cells[1] = {{0, 1}, {1, 1}, {1, 2}, {2, 1}};
-    tBlock.cells[2] = {{1, 0}, {1, 1}, {1, 2}, {2, 1}};
-    tBlock.cells[3] = {{0, 1}, {1, 0}, {1, 1}, {2, 1}};
-
-    moveBlock(tBlock, 0, 3);
-
-    zBlock.id = 7;
-    zBlock.cells[0] = {{0, 0}, {0, 1}, {1, 1}, {1, 2}};
-    zBlock.cells[1] = {{0, 2}, {1, 1}, {1, 2}, {2, 1}};
-    zBlock.cells[2] = {{1, 0}, {1, 1}, {2, 1}, {2, 2}};
-    zBlock.cells[3] = {{0, 1}, {1, 0}, {1, 1}, {2, 0}};
-
-    moveBlock(zBlock, 0, 3);
-
-    blocks.reserve(7);
-    blocks = {lBlock, jBlock, iBlock, oBlock, sBlock, tBlock, zBlock};
-
-    currentBlock = getRandomBlock();
-    nextBlock = getRandomBlock();
-}
 
-SDL_Color getColorByIndex(int index)
-{
-    const SDL_Color lightGrey = {80, 80, 80, 255};
-    const SDL_Color green = {47, 230, 23, 255};
-    const SDL_Color red = {232, 18, 18, 255};
-    const SDL_Color orange = {226, 116, 17, 255};
-    const SDL_Color yellow = {237, 234, 4, 255};
-    const SDL_Color purple = {166, 0, 247, 255};
-    const SDL_Color cyan = {21, 204, 209, 255};
-    const SDL_Color blue = {13, 64, 216, 255};
-
-    SDL_Color colors[] = {lightGrey, green, red, orange, yellow, purple, cyan, blue};
-
-    return colors[index];
+    clearEvents(game);
 }
 
 void drawGrid()
 {
+    TRACE_ZONE("drawGrid");
+
     for (int row = 0; row < TOTAL_ROWS; row++)
     {
         for (int column = 0; column < TOTAL_COLUMNS; column++)
         {
-            int cellValue = grid[row][column];
-
-            SDL_Color cellColor = getColorByIndex(cellValue);
-            SDL_SetRenderDrawColor(renderer, cellColor.r, cellColor.g, cellColor.b, cellColor.a);
+            int cellValue = getCellId(game.board, row, column);
 
             SDL_Rect rect = {column * CELL_SIZE + POSITION_OFFSET, row * CELL_SIZE + POSITION_OFFSET, CELL_SIZE - CELL_OFFSET, CELL_SIZE - CELL_OFFSET};
-            SDL_RenderFillRect(renderer, &rect);
+            addRect(rectBatch, rect, CELL_COLORS[cellValue]);
         }
     }
 }
 
-void drawBlock(Block &block, int offsetX, int offsetY)
+void updateBoardTexture()
 {
-    vector<Vector2> blockTiles = getCellPositions(block);
+    if (game.dirtyRows == 0)
+    {
+        return;
+    }
+
+    TRACE_ZONE("updateBoardTexture");
+
+    SDL_SetRenderTarget(renderer, boardTexture);
 
-    for (Vector2 blockTile : blockTiles)
+    for (int row = 0; row < TOTAL_ROWS; row++)
     {
-        SDL_Color cellColor = getColorByIndex(block.id);
-        SDL_SetRenderDrawColor(renderer, cellColor.r, cellColor.g, cellColor.b, cellColor.a);
+        if ((game.dirtyRows & (1 << row)) == 0)
+        {
+            continue;
+        }
 
-        SDL_Rect rect = {(int)blockTile.y * CELL_SIZE + offsetX, (int)blockTile.x * CELL_SIZE + offsetY, CELL_SIZE - CELL_OFFSET, CELL_SIZE - CELL_OFFSET};
-        SDL_RenderFillRect(renderer, &rect);
+        // the background of the whole row first, so the gaps between the cells are clean too.
+        SDL_Rect rowRect = {0, row * CELL_SIZE, TOTAL_COLUMNS * CELL_SIZE, CELL_SIZE};
+        addRect(rectBatch, rowRect, BACKGROUND_COLOR);
+
+        for (int column = 0; column < TOTAL_COLUMNS; column++)
+        {
+            SDL_Rect rect = {column * CELL_SIZE, row * CELL_SIZE, CELL_SIZE - CELL_OFFSET, CELL_SIZE - CELL_OFFSET};
+            addRect(rectBatch, rect, CELL_COLORS[getCellId(game.board, row, column)]);
+        }
     }
+
+    drawRectBatch(renderer, rectBatch);
+    SDL_SetRenderTarget(renderer, NULL);
+
+    game.dirtyRows = 0;
 }
 
-void drawBlock(Block &block)
+void drawBlock(Block &block, int offsetX, int offsetY)
 {
-    vector<Vector2> blockTiles = getCellPositions(block);
+    CellOffset blockTiles[CELLS_PER_BLOCK];
+    getCellPositions(block, blockTiles);
 
-    for (Vector2 blockTile : blockTiles)
+    for (CellOffset blockTile : blockTiles)
     {
-        SDL_Color cellColor = getColorByIndex(block.id);
-        SDL_SetRenderDrawColor(renderer, cellColor.r, cellColor.g, cellColor.b, cellColor.a);
-
-        SDL_Rect rect = {(int)blockTile.y * CELL_SIZE + POSITION_OFFSET, (int)blockTile.x * CELL_SIZE + POSITION_OFFSET, CELL_SIZE - CELL_OFFSET, CELL_SIZE - CELL_OFFSET};
-        SDL_RenderFillRect(renderer, &rect);
+        SDL_Rect rect = {blockTile.column * CELL_SIZE + offsetX, blockTile.row * CELL_SIZE + offsetY, CELL_SIZE - CELL_OFFSET, CELL_SIZE - CELL_OFFSET};
+        addRect(rectBatch, rect, CELL_COLORS[block.id]);
     }
 }
 
-void render()
+void drawBlock(Block &block)
 {
-    SDL_SetRenderDrawColor(renderer, 29, 29, 27, 255);
-    SDL_RenderClear(renderer);
+    drawBlock(block, POSITION_OFFSET, POSITION_OFFSET);
+}
 
-    drawGrid();
+void render()
+{
+    TRACE_ZONE("render");
 
-    drawBlock(currentBlock);
+    if (boardTexture != nullptr)
+    {
+        updateBoardTexture();
+    }
 
-    SDL_SetRenderDrawColor(renderer, 80, 80, 80, 255);
+    SDL_SetRenderDrawColor(renderer, BACKGROUND_COLOR.r, BACKGROUND_COLOR.g, BACKGROUND_COLOR.b, BACKGROUND_COLOR.a);
+    SDL_RenderClear(renderer);
 
-    SDL_RenderCopy(renderer, scoreTextTexture, NULL, &scoreTextBounds);
+    if (boardTexture != nullptr)
+    {
+        SDL_Rect boardBounds = {POSITION_OFFSET, POSITION_OFFSET, TOTAL_COLUMNS * CELL_SIZE, TOTAL_ROWS * CELL_SIZE};
+        SDL_RenderCopy(renderer, boardTexture, NULL, &boardBounds);
+    }
 
+    // the ui boxes go first so the next block is drawn over its box, the texts are drawn after the batch.
     SDL_Rect scorePlaceHolderRect = {315, 55, 170, 60};
-    SDL_RenderFillRect(renderer, &scorePlaceHolderRect);
+    addRect(rectBatch, scorePlaceHolderRect, lightGrey);
 
-    updateTextureText(scoreTexture, std::to_string(score).c_str(), font, renderer);
+    SDL_Rect nextBlockPlaceHolderRect = {315, 215, 170, 180};
+    addRect(rectBatch, nextBlockPlaceHolderRect, lightGrey);
 
-    SDL_QueryTexture(scoreTexture, NULL, NULL, &scoreBounds.w, &scoreBounds.h);
-    scoreBounds.x = 365;
-    scoreBounds.y = 65;
-    SDL_RenderCopy(renderer, scoreTexture, NULL, &scoreBounds);
+    if (boardTexture == nullptr)
+    {
+        drawGrid();
+    }
 
-    SDL_RenderCopy(renderer, nextTexture, NULL, &nextBounds);
+    drawBlock(game.currentBlock);
 
-    SDL_Rect nextBlockPlaceHolderRect = {315, 215, 170, 180};
-    SDL_RenderFillRect(renderer, &nextBlockPlaceHolderRect);
+    Block nextBlock = createBlock(peekPiece(game.queue, 0));
 
     if (nextBlock.id == 3)
     {
@@ -602,28 +478,188 @@ void render()
         drawBlock(nextBlock, 275, 270);
     }
 
-    if (isGameOver)
+    drawRectBatch(renderer, rectBatch);
+
+    const SDL_Color white = {255, 255, 255, 255};
+
+    char scoreText[16];
+    snprintf(scoreText, sizeof(scoreText), "%d", game.score);
+
+    addText(textBatch, fontAtlas, "Score", SCORE_LABEL_POSITION.x, SCORE_LABEL_POSITION.y, white);
+    addText(textBatch, fontAtlas, scoreText, SCORE_POSITION.x, SCORE_POSITION.y, white);
+    addText(textBatch, fontAtlas, "Next", NEXT_LABEL_POSITION.x, NEXT_LABEL_POSITION.y, white);
+
+    if (game.isGameOver)
     {
-        updateTextureText(pauseTexture, "Game Over", font, renderer);
-        SDL_RenderCopy(renderer, pauseTexture, NULL, &pauseBounds);
+        addText(textBatch, fontAtlas, "Game Over", PAUSE_POSITION.x, PAUSE_POSITION.y, white);
     }
 
-    if (isGamePaused)
+    if (game.isGamePaused)
     {
-        updateTextureText(pauseTexture, "Game Pause", font, renderer);
-        SDL_RenderCopy(renderer, pauseTexture, NULL, &pauseBounds);
+        addText(textBatch, fontAtlas, "Game Pause", PAUSE_POSITION.x, PAUSE_POSITION.y, white);
     }
 
+    drawRectBatch(renderer, textBatch, fontAtlas.texture);
+
     SDL_RenderPresent(renderer);
 }
 
+// --benchmark FRAMES: the bot plays the same seeded games for that many frames, one game tick per frame and no frame
+// pacing, then the frame rate and the timings are printed. With SDL_VIDEODRIVER=dummy it runs without a display.
+const uint64_t BENCHMARK_SEED = 1;
+// the block and the next one, a fixed depth instead of the time budget of the window.
+const int BENCHMARK_SEARCH_DEPTH = 2;
+
+int benchmarkFrames = 0;
+
+void runBenchmark(int totalFrames)
+{
+    TRACE_ZONE("runBenchmark");
+
+    // a fixed depth on this thread, without the deadline and the shared table, so every run plays the same placements.
+    isBotPlaying = true;
+    bot.search = {BENCHMARK_SEARCH_DEPTH, DEFAULT_BEAM_WIDTH, 0, nullptr, nullptr};
+    resetBot(bot);
+    startGame(BENCHMARK_SEED);
+
+    Uint64 frequency = SDL_GetPerformanceFrequency();
+    Uint64 updateTime = 0;
+    Uint64 renderTime = 0;
+    Uint64 benchmarkStart = SDL_GetPerformanceCounter();
+
+    for (int frame = 0; frame < totalFrames; frame++)
+    {
+        Uint64 frameStart = SDL_GetPerformanceCounter();
+        Uint64 phaseStart = markPhase(frameTimer, PHASE_CONTROLLER, frameStart, frameStart);
+
+        handleEvents();
+        phaseStart = markPhase(frameTimer, PHASE_EVENTS, phaseStart, SDL_GetPerformanceCounter());
+
+        update(frame);
+
+        if (game.isGameOver)
+        {
+            startGame(nextRandom(game.random));
+        }
+
+        Uint64 updateEnd = SDL_GetPerformanceCounter();
+        updateTime += updateEnd - phaseStart;
+        phaseStart = markPhase(frameTimer, PHASE_UPDATE, phaseStart, updateEnd);
+
+        playGameSounds();
+        phaseStart = markPhase(frameTimer, PHASE_SOUNDS, phaseStart, SDL_GetPerformanceCounter());
+
+        render();
+
+        Uint64 renderEnd = SDL_GetPerformanceCounter();
+        renderTime += renderEnd - phaseStart;
+        phaseStart = markPhase(frameTimer, PHASE_RENDER, phaseStart, renderEnd);
+        phaseStart = markPhase(frameTimer, PHASE_FRAME_CAP, phaseStart, phaseStart);
+
+        markPhase(frameTimer, PHASE_FRAME, frameStart, phaseStart);
+        endFrame(frameTimer);
+    }
+
+    double seconds = (double)(SDL_GetPerformanceCounter() - benchmarkStart) / frequency;
+
+    printf("benchmark: %d frames in %.3f s, %.1f fps\n", totalFrames, seconds, totalFrames / seconds);
+    printf("update %.3f s (%.1f%%), render %.3f s (%.1f%%), score %d\n", (double)updateTime / frequency, updateTime * 100.0 / frequency / seconds,
+           (double)renderTime / frequency, renderTime * 100.0 / frequency / seconds, game.score);
+    printFrameTimings(frameTimer, stdout);
+}
+
+bool isIdle()
+{
+    return game.isGamePaused || game.isGameOver || isWindowMinimized || !hasWindowFocus;
+}
+
+// one iteration of the main loop while idle: no game ticks, no frame pacing and no timings, the wait for events is the frame.
+void idle()
+{
+    TRACE_ZONE("idle");
+
+    if (!wasIdle)
+    {
+        wasIdle = true;
+        needsRedraw = true;
+        Mix_VolumeMusic(IDLE_MUSIC_VOLUME);
+    }
+
+    if (needsRedraw && !isWindowMinimized)
+    {
+        needsRedraw = false;
+        render();
+    }
+
+    SDL_WaitEventTimeout(NULL, IDLE_WAIT_MILLISECONDS);
+
+    lastPollTime = pollTime;
+    pollTime = SDL_GetTicks();
+    frameTicks = 0;
+
+    SDL_GameControllerUpdate();
+    handleEvents();
+    settleInput(input);
+    playGameSounds();
+}
+
+void leaveIdle()
+{
+    wasIdle = false;
+    Mix_VolumeMusic(MIX_MAX_VOLUME);
+
+    // the time spent idle is not played, and the frames start again from now.
+    skipSimTime(simClock, SDL_GetPerformanceCounter());
+    restartFramePacer(framePacer);
+}
+
 int main(int argc, char *args[])
 {
+    InputConfig inputConfig = DEFAULT_INPUT_CONFIG;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(args[i], "--bot") == 0)
+        {
+            isBotPlaying = true;
+        }
+
+        else if (strcmp(args[i], "--benchmark") == 0 && i + 1 < argc)
+        {
+            benchmarkFrames = std::max(atoi(args[++i]), 1);
+        }
+
+        // the delays of the moves in ticks of 1/60 s, --arr 0 moves to the wall.
+        else if (strcmp(args[i], "--das") == 0 && i + 1 < argc)
+        {
+            inputConfig.dasTicks = std::max(atoi(args[++i]), 0);
+        }
+
+        else if (strcmp(args[i], "--arr") == 0 && i + 1 < argc)
+        {
+            inputConfig.arrTicks = std::max(atoi(args[++i]), 0);
+        }
+
+        else if (strcmp(args[i], "--sdf") == 0 && i + 1 < argc)
+        {
+            inputConfig.softDropTicks = std::max(atoi(args[++i]), 1);
+        }
+    }
+
+    // the benchmark needs no sound card, and takes any renderer so the software one works without a display.
+    Uint32 rendererFlags = SDL_RENDERER_ACCELERATED;
+
+    if (benchmarkFrames > 0)
+    {
+        SDL_setenv("SDL_AUDIODRIVER", "dummy", 0);
+        rendererFlags = 0;
+    }
+
     // SCREEN_WIDTH 10 * 30 = 300 + 200 = 500
     // SCREEN_HEIGHT 18 * 30 = 540 + 4 = 544
     // need to give a extra offset of 200 width and 20 heigt for the ui
     window = SDL_CreateWindow("My Window", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, TOTAL_COLUMNS * CELL_SIZE + 200, TOTAL_ROWS * CELL_SIZE + 4, SDL_WINDOW_SHOWN);
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    renderer = SDL_CreateRenderer(window, -1, rendererFlags);
 
     if (startSDL(window, renderer) > 0)
     {
@@ -646,22 +682,8 @@ int main(int argc, char *args[])
 
     font = TTF_OpenFont("res/fonts/monogram.ttf", 36);
 
-    updateTextureText(scoreTexture, "0", font, renderer);
-
-    updateTextureText(scoreTextTexture, "Score", font, renderer);
-    SDL_QueryTexture(scoreTextTexture, NULL, NULL, &scoreTextBounds.w, &scoreTextBounds.h);
-    scoreTextBounds.x = 365;
-    scoreTextBounds.y = 15;
-
-    updateTextureText(nextTexture, "Next", font, renderer);
-    SDL_QueryTexture(nextTexture, NULL, NULL, &nextBounds.w, &nextBounds.h);
-    nextBounds.x = 370;
-    nextBounds.y = 175;
-
-    updateTextureText(pauseTexture, "Game Paused", font, renderer);
-    SDL_QueryTexture(pauseTexture, NULL, NULL, &pauseBounds.w, &pauseBounds.h);
-    pauseBounds.x = 330;
-    pauseBounds.y = 450;
+    createGlyphAtlas(fontAtlas, font, renderer);
+    createRectBatch(textBatch);
 
     pauseSound = loadSound("res/sounds/okay.wav");
     music = loadMusic("res/music/music.wav");
@@ -671,37 +693,82 @@ int main(int argc, char *args[])
 
     Mix_PlayMusic(music, -1);
 
-    initializeGrid();
-    initializeBlocks();
+    startGame(SDL_GetPerformanceCounter());
+    resetInput(input, inputConfig);
+
+    startThreadPool(pool, getDefaultWorkerCount() - 1);
 
-    Uint32 previousFrameTime = SDL_GetTicks();
-    Uint32 currentFrameTime = previousFrameTime;
-    float deltaTime = 0.0f;
+    bot.search = {MAX_SEARCH_DEPTH, DEFAULT_BEAM_WIDTH, BOT_TIME_BUDGET, &pool, &table};
+    resetBot(bot);
 
-    while (true)
+    createRectBatch(rectBatch);
+    createBoardTexture();
+    resetFrameTimer(frameTimer, SDL_GetPerformanceFrequency());
+    resetSimClock(simClock, SDL_GetPerformanceFrequency(), SDL_GetPerformanceCounter());
+    startFramePacer(framePacer, getDisplayRefreshRate(window));
+    pollTime = SDL_GetTicks();
+
+    if (benchmarkFrames > 0)
     {
-        currentFrameTime = SDL_GetTicks();
-        deltaTime = (currentFrameTime - previousFrameTime) / 1000.0f;
-        previousFrameTime = currentFrameTime;
+        runBenchmark(benchmarkFrames);
+        stopThreadPool(pool);
+        TRACE_WRITE("trace.json");
+    }
+
+    while (benchmarkFrames == 0)
+    {
+        if (isIdle())
+        {
+            idle();
+            continue;
+        }
+
+        if (wasIdle)
+        {
+            leaveIdle();
+        }
+
+        Uint64 frameStart = SDL_GetPerformanceCounter();
+        Uint64 phaseStart = frameStart;
 
         SDL_GameControllerUpdate();
+        phaseStart = markPhase(frameTimer, PHASE_CONTROLLER, phaseStart, SDL_GetPerformanceCounter());
+
+        // the ticks of the frame are known before the events, so every event can go in the tick it happened in.
+        // The time keeps going while the game is paused, those ticks are dropped.
+        lastPollTime = pollTime;
+        pollTime = SDL_GetTicks();
+        frameTicks = advanceSimClock(simClock, SDL_GetPerformanceCounter());
 
         handleEvents();
+        phaseStart = markPhase(frameTimer, PHASE_EVENTS, phaseStart, SDL_GetPerformanceCounter());
 
-        if (!isGamePaused)
+        uint64_t firstTick = simClock.totalTicks - frameTicks;
+
+        for (int i = 0; i < frameTicks && !game.isGamePaused; i++)
         {
-            update(deltaTime);
+            update(firstTick + i);
         }
 
+        saveFinishedGame();
+        phaseStart = markPhase(frameTimer, PHASE_UPDATE, phaseStart, SDL_GetPerformanceCounter());
+
+        playGameSounds();
+        phaseStart = markPhase(frameTimer, PHASE_SOUNDS, phaseStart, SDL_GetPerformanceCounter());
+
         render();
+        phaseStart = markPhase(frameTimer, PHASE_RENDER, phaseStart, SDL_GetPerformanceCounter());
+
+        waitNextFrame(framePacer);
+        phaseStart = markPhase(frameTimer, PHASE_FRAME_CAP, phaseStart, SDL_GetPerformanceCounter());
 
-        // capping the game at 60
-        capFrameRate(currentFrameTime);
+        markPhase(frameTimer, PHASE_FRAME, frameStart, phaseStart);
+        endFrame(frameTimer);
     }
 
     Mix_FreeMusic(music);
     Mix_FreeChunk(pauseSound);
-    SDL_DestroyTexture(pauseTexture);
+    destroyGlyphAtlas(fontAtlas);
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     Mix_CloseAudio();
@@ -0,0 +1,437 @@
+#include "move_generator.h"
+
+// the block offsets go from -3 to 12 in the columns and from -3 to the last row in the rows.
+const int MOVE_ROW_BIAS = 3;
+const int TOTAL_ROW_POSITIONS = TOTAL_ROWS + MOVE_ROW_BIAS;
+const int TOTAL_EXTENDED_ROWS = TOTAL_ROWS + 2 * MOVE_ROW_BIAS + 1;
+const int MAX_ROW_STATES = TOTAL_ROTATIONS * 16;
+
+// the walls and everything above and below the board are filled, so they collide like any other cell.
+const uint32_t WALL_MASK = ~((uint32_t)FULL_ROW_MASK << MOVE_COLUMN_BIAS);
+
+typedef struct
+{
+    int id;
+    int totalRotations;
+    int startRow;
+    int startRotation;
+    int startColumn;
+    uint16_t fits[TOTAL_ROTATIONS][TOTAL_ROW_POSITIONS + 1];
+    uint16_t reach[TOTAL_ROTATIONS][TOTAL_ROW_POSITIONS];
+} MoveSearch;
+
+void fillExtendedRows(const Board &board, uint32_t extendedRows[TOTAL_EXTENDED_ROWS])
+{
+    for (int i = 0; i < TOTAL_EXTENDED_ROWS; i++)
+    {
+        int row = i - MOVE_ROW_BIAS;
+
+        if (row >= 0 && row < TOTAL_ROWS)
+        {
+            extendedRows[i] = ((uint32_t)board.rows[row] << MOVE_COLUMN_BIAS) | WALL_MASK;
+        }
+        else
+        {
+            extendedRows[i] = 0xFFFFFFFF;
+        }
+    }
+}
+
+// all the columns of one row at once: a cell blocks every column where the block would put a cell on top of it.
+uint16_t getFittingColumns(const uint32_t extendedRows[TOTAL_EXTENDED_ROWS], int id, int rotation, int row)
+{
+    const CellOffset *cells = BLOCK_CELLS[id][rotation];
+    uint32_t blocked = 0;
+
+    for (int i = 0; i < CELLS_PER_BLOCK; i++)
+    {
+        blocked |= extendedRows[row + cells[i].row + MOVE_ROW_BIAS] >> cells[i].column;
+    }
+
+    return (uint16_t)~blocked;
+}
+
+uint16_t getFittingColumns(const Board &board, int id, int rotation, int row)
+{
+    uint32_t extendedRows[TOTAL_EXTENDED_ROWS];
+    fillExtendedRows(board, extendedRows);
+
+    return getFittingColumns(extendedRows, id, rotation, row);
+}
+
+uint16_t spreadSideways(uint16_t reach, uint16_t fits)
+{
+    while (true)
+    {
+        uint16_t spread = reach | (((reach << 1) | (reach >> 1)) & fits);
+
+        if (spread == reach)
+        {
+            return reach;
+        }
+
+        reach = spread;
+    }
+}
+
+void findReachableStates(MoveSearch &search)
+{
+    for (int position = search.startRow; position < TOTAL_ROW_POSITIONS; position++)
+    {
+        uint16_t anyReach = 0;
+
+        for (int rotation = 0; rotation < search.totalRotations; rotation++)
+        {
+            if (position > search.startRow)
+            {
+                search.reach[rotation][position] = search.reach[rotation][position - 1] & search.fits[rotation][position];
+            }
+
+            anyReach |= search.reach[rotation][position];
+        }
+
+        if (anyReach == 0)
+        {
+            return;
+        }
+
+        // moving sideways and rotating inside the row until nothing new can be reached.
+        bool hasChanged = true;
+
+        while (hasChanged)
+        {
+            hasChanged = false;
+
+            for (int rotation = 0; rotation < search.totalRotations; rotation++)
+            {
+                uint16_t reach = spreadSideways(search.reach[rotation][position], search.fits[rotation][position]);
+                search.reach[rotation][position] = reach;
+
+                int nextRotation = (rotation + 1) % search.totalRotations;
+                uint16_t rotated = reach & search.fits[nextRotation][position] & ~search.reach[nextRotation][position];
+
+                if (rotated != 0)
+                {
+                    search.reach[nextRotation][position] |= rotated;
+                    hasChanged = true;
+                }
+            }
+        }
+    }
+}
+
+bool isReachable(const MoveSearch &search, int rotation, int position, int column)
+{
+    return column >= 0 && column < 16 && ((search.reach[rotation][position] >> column) & 1);
+}
+
+bool isRowEntry(const MoveSearch &search, int rotation, int position, int column)
+{
+    if (position == search.startRow)
+    {
+        return rotation == search.startRotation && column == search.startColumn;
+    }
+
+    return isReachable(search, rotation, position - 1, column);
+}
+
+// rotating in place and then sliding, the way most blocks are moved from where they start.
+int findDirectSegment(const MoveSearch &search, int rotation, int column, uint8_t segment[MAX_ROW_STATES])
+{
+    int position = search.startRow;
+    int totalRotates = (rotation - search.startRotation + search.totalRotations) % search.totalRotations;
+
+    for (int i = 1; i <= totalRotates; i++)
+    {
+        if (!isReachable(search, (search.startRotation + i) % search.totalRotations, position, search.startColumn))
+        {
+            return -1;
+        }
+    }
+
+    int lowColumn = column < search.startColumn ? column : search.startColumn;
+    int highColumn = column < search.startColumn ? search.startColumn : column;
+    uint16_t slideMask = (uint16_t)(((1u << (highColumn + 1)) - 1) & ~((1u << lowColumn) - 1));
+
+    if ((search.reach[rotation][position] & slideMask) != slideMask)
+    {
+        return -1;
+    }
+
+    int segmentLength = 0;
+
+    for (int i = 0; i < totalRotates; i++)
+    {
+        segment[segmentLength++] = ACTION_ROTATE;
+    }
+
+    for (int i = lowColumn; i < highColumn; i++)
+    {
+        segment[segmentLength++] = column < search.startColumn ? ACTION_LEFT : ACTION_RIGHT;
+    }
+
+    return segmentLength;
+}
+
+// a small breadth first search inside one row, back from the target to the state where the block entered the row.
+int findRowSegment(const MoveSearch &search, int position, int &rotation, int &column, uint8_t segment[MAX_ROW_STATES])
+{
+    int8_t nextState[MAX_ROW_STATES];
+    uint8_t nextAction[MAX_ROW_STATES];
+    int queue[MAX_ROW_STATES];
+    uint16_t visited[TOTAL_ROTATIONS] = {};
+
+    int first = 0;
+    int last = 0;
+    int target = rotation * 16 + column;
+    int entry = -1;
+
+    queue[last++] = target;
+    visited[rotation] |= 1 << column;
+
+    while (first < last)
+    {
+        int state = queue[first++];
+        int stateRotation = state / 16;
+        int stateColumn = state % 16;
+
+        if (isRowEntry(search, stateRotation, position, stateColumn))
+        {
+            entry = state;
+            break;
+        }
+
+        int previousRotation = (stateRotation + search.totalRotations - 1) % search.totalRotations;
+        int predecessors[3][3] = {
+            {stateRotation, stateColumn - 1, ACTION_RIGHT},
+            {stateRotation, stateColumn + 1, ACTION_LEFT},
+            {previousRotation, stateColumn, ACTION_ROTATE}};
+
+        for (int i = 0; i < 3; i++)
+        {
+            int predecessorRotation = predecessors[i][0];
+            int predecessorColumn = predecessors[i][1];
+
+            if (!isReachable(search, predecessorRotation, position, predecessorColumn) || ((visited[predecessorRotation] >> predecessorColumn) & 1))
+            {
+                continue;
+            }
+
+            int predecessor = predecessorRotation * 16 + predecessorColumn;
+
+            visited[predecessorRotation] |= 1 << predecessorColumn;
+            nextState[predecessor] = state;
+            nextAction[predecessor] = predecessors[i][2];
+            queue[last++] = predecessor;
+        }
+    }
+
+    if (entry == -1)
+    {
+        return -1;
+    }
+
+    int segmentLength = 0;
+
+    for (int state = entry; state != target; state = nextState[state])
+    {
+        segment[segmentLength++] = nextAction[state];
+    }
+
+    rotation = entry / 16;
+    column = entry % 16;
+
+    return segmentLength;
+}
+
+// walks back from the placement: up while the block could have come from the row above, and inside a row
+// to the state where it entered the row. The actions are collected from the last one and reversed at the end.
+bool buildPath(const MoveSearch &search, int rotation, int position, int column, PlacementPath &path)
+{
+    uint8_t reversedPath[MAX_PATH_LENGTH];
+    int pathLength = 0;
+
+    while (true)
+    {
+        // most of the path is the block falling straight down.
+        while (position > search.startRow && isReachable(search, rotation, position - 1, column))
+        {
+            if (pathLength + 1 > MAX_PATH_LENGTH)
+            {
+                return false;
+            }
+
+            reversedPath[pathLength++] = ACTION_DOWN;
+            position--;
+        }
+
+        uint8_t segment[MAX_ROW_STATES];
+        int segmentLength = -1;
+
+        if (position == search.startRow)
+        {
+            segmentLength = findDirectSegment(search, rotation, column, segment);
+        }
+
+        if (segmentLength >= 0)
+        {
+            rotation = search.startRotation;
+            column = search.startColumn;
+        }
+        else
+        {
+            segmentLength = findRowSegment(search, position, rotation, column, segment);
+        }
+
+        if (segmentLength < 0 || pathLength + segmentLength + 1 > MAX_PATH_LENGTH)
+        {
+            return false;
+        }
+
+        for (int i = segmentLength - 1; i >= 0; i--)
+        {
+            reversedPath[pathLength++] = segment[i];
+        }
+
+        if (position == search.startRow)
+        {
+            break;
+        }
+
+        reversedPath[pathLength++] = ACTION_DOWN;
+        position--;
+    }
+
+    path.length = pathLength;
+
+    for (int i = 0; i < pathLength; i++)
+    {
+        path.actions[i] = reversedPath[pathLength - 1 - i];
+    }
+
+    return true;
+}
+
+// the row of the first filled cell and the four row masks, enough to tell apart two sets of locked cells.
+uint64_t getPlacementKey(int id, int rotation, int row, int column)
+{
+    const CellOffset *cells = BLOCK_CELLS[id][rotation];
+
+    int topRow = row + cells[0].row;
+
+    for (int i = 1; i < CELLS_PER_BLOCK; i++)
+    {
+        topRow = row + cells[i].row < topRow ? row + cells[i].row : topRow;
+    }
+
+    uint64_t key = (uint64_t)(topRow + MOVE_ROW_BIAS) << 40;
+
+    for (int i = 0; i < CELLS_PER_BLOCK; i++)
+    {
+        key |= (uint64_t)1 << ((row + cells[i].row - topRow) * TOTAL_COLUMNS + column + cells[i].column);
+    }
+
+    return key;
+}
+
+// false when the block doesn't fit where it starts, so nothing is reachable.
+bool searchReachableStates(const Board &board, const Block &start, MoveSearch &search)
+{
+    search.id = start.id;
+    search.totalRotations = BLOCK_ROTATIONS[start.id];
+    search.startRow = start.rowOffset + MOVE_ROW_BIAS;
+    search.startRotation = start.rotationState;
+    search.startColumn = start.columnOffset + MOVE_COLUMN_BIAS;
+
+    uint32_t extendedRows[TOTAL_EXTENDED_ROWS];
+    fillExtendedRows(board, extendedRows);
+
+    for (int rotation = 0; rotation < search.totalRotations; rotation++)
+    {
+        for (int position = 0; position < TOTAL_ROW_POSITIONS; position++)
+        {
+            search.fits[rotation][position] = getFittingColumns(extendedRows, start.id, rotation, position - MOVE_ROW_BIAS);
+            search.reach[rotation][position] = 0;
+        }
+
+        search.fits[rotation][TOTAL_ROW_POSITIONS] = 0;
+    }
+
+    if (!((search.fits[search.startRotation][search.startRow] >> search.startColumn) & 1))
+    {
+        return false;
+    }
+
+    search.reach[search.startRotation][search.startRow] = 1 << search.startColumn;
+
+    findReachableStates(search);
+
+    return true;
+}
+
+void generatePlacements(const Board &board, const Block &start, PlacementList &placements)
+{
+    placements.totalPlacements = 0;
+
+    MoveSearch search;
+
+    if (!searchReachableStates(board, start, search))
+    {
+        return;
+    }
+
+    uint64_t keys[MAX_PLACEMENTS];
+
+    for (int position = search.startRow; position < TOTAL_ROW_POSITIONS; position++)
+    {
+        for (int rotation = 0; rotation < search.totalRotations; rotation++)
+        {
+            // the block lands where it's reachable but can't go one row down.
+            uint16_t landings = search.reach[rotation][position] & ~search.fits[rotation][position + 1];
+
+            while (landings != 0 && placements.totalPlacements < MAX_PLACEMENTS)
+            {
+                int column = __builtin_ctz(landings);
+                landings &= landings - 1;
+
+                int row = position - MOVE_ROW_BIAS;
+                uint64_t key = getPlacementKey(start.id, rotation, row, column - MOVE_COLUMN_BIAS);
+                bool isDuplicate = false;
+
+                for (int i = 0; i < placements.totalPlacements && !isDuplicate; i++)
+                {
+                    isDuplicate = keys[i] == key;
+                }
+
+                if (isDuplicate)
+                {
+                    continue;
+                }
+
+                placements.placements[placements.totalPlacements].block = {(int8_t)start.id, (int8_t)rotation, (int8_t)row, (int8_t)(column - MOVE_COLUMN_BIAS)};
+                keys[placements.totalPlacements] = key;
+                placements.totalPlacements++;
+            }
+        }
+    }
+}
+
+bool findPlacementPath(const Board &board, const Block &start, const Block &placement, PlacementPath &path)
+{
+    MoveSearch search;
+
+    if (placement.id != start.id || !searchReachableStates(board, start, search))
+    {
+        return false;
+    }
+
+    int position = placement.rowOffset + MOVE_ROW_BIAS;
+    int column = placement.columnOffset + MOVE_COLUMN_BIAS;
+
+    if (position < search.startRow || position >= TOTAL_ROW_POSITIONS || !isReachable(search, placement.rotationState, position, column))
+    {
+        return false;
+    }
+
+    return buildPath(search, placement.rotationState, position, column, path);
+}
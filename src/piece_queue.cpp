@@ -0,0 +1,72 @@
+#include "piece_queue.h"
+
+void pushShuffledBag(PieceQueue &queue, Random &random)
+{
+    int8_t bag[TOTAL_BLOCK_TYPES];
+
+    for (int i = 0; i < TOTAL_BLOCK_TYPES; i++)
+    {
+        bag[i] = i + 1;
+    }
+
+    // Fisher-Yates shuffle
+    for (int i = TOTAL_BLOCK_TYPES - 1; i > 0; i--)
+    {
+        int j = randomRange(random, 0, i);
+
+        int8_t id = bag[i];
+        bag[i] = bag[j];
+        bag[j] = id;
+    }
+
+    for (int i = 0; i < TOTAL_BLOCK_TYPES; i++)
+    {
+        queue.ids[(queue.first + queue.totalIds) & (PIECE_QUEUE_CAPACITY - 1)] = bag[i];
+        queue.totalIds++;
+    }
+}
+
+void fillPieceQueue(PieceQueue &queue, Random &random)
+{
+    while (queue.totalIds < queue.depth)
+    {
+        pushShuffledBag(queue, random);
+    }
+}
+
+void resetPieceQueue(PieceQueue &queue, Random &random, int depth)
+{
+    queue.first = 0;
+    queue.totalIds = 0;
+
+    setPreviewDepth(queue, random, depth);
+}
+
+void setPreviewDepth(PieceQueue &queue, Random &random, int depth)
+{
+    if (depth < MIN_PREVIEW_DEPTH)
+    {
+        depth = MIN_PREVIEW_DEPTH;
+    }
+
+    if (depth > MAX_PREVIEW_DEPTH)
+    {
+        depth = MAX_PREVIEW_DEPTH;
+    }
+
+    queue.depth = depth;
+
+    fillPieceQueue(queue, random);
+}
+
+int takePiece(PieceQueue &queue, Random &random)
+{
+    int id = queue.ids[queue.first];
+
+    queue.first = (queue.first + 1) & (PIECE_QUEUE_CAPACITY - 1);
+    queue.totalIds--;
+
+    fillPieceQueue(queue, random);
+
+    return id;
+}
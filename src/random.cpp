@@ -0,0 +1,93 @@
+#include "random.h"
+
+uint64_t rotateLeft(uint64_t value, int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+uint64_t splitMix(uint64_t &value)
+{
+    value += 0x9E3779B97F4A7C15ull;
+
+    uint64_t result = value;
+    result = (result ^ (result >> 30)) * 0xBF58476D1CE4E5B9ull;
+    result = (result ^ (result >> 27)) * 0x94D049BB133111EBull;
+
+    return result ^ (result >> 31);
+}
+
+void seedRandom(Random &random, uint64_t seed)
+{
+    // splitmix never gives four zeros in a row, so the state is always valid.
+    for (int i = 0; i < 4; i++)
+    {
+        random.state[i] = splitMix(seed);
+    }
+}
+
+uint64_t nextRandom(Random &random)
+{
+    uint64_t *state = random.state;
+
+    uint64_t result = rotateLeft(state[1] * 5, 7) * 9;
+    uint64_t shifted = state[1] << 17;
+
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+
+    state[2] ^= shifted;
+    state[3] = rotateLeft(state[3], 45);
+
+    return result;
+}
+
+int randomRange(Random &random, int min, int max)
+{
+    // multiply and shift instead of the modulo, rejecting the few values that would make some results more likely.
+    uint32_t range = max - min + 1;
+    uint64_t product = (nextRandom(random) >> 32) * range;
+    uint32_t low = (uint32_t)product;
+
+    if (low < range)
+    {
+        uint32_t threshold = -range % range;
+
+        while (low < threshold)
+        {
+            product = (nextRandom(random) >> 32) * range;
+            low = (uint32_t)product;
+        }
+    }
+
+    return min + (int)(product >> 32);
+}
+
+void jumpRandom(Random &random)
+{
+    const uint64_t JUMP[] = {0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull};
+
+    uint64_t jumped[4] = {0, 0, 0, 0};
+
+    for (uint64_t jump : JUMP)
+    {
+        for (int bit = 0; bit < 64; bit++)
+        {
+            if (jump & ((uint64_t)1 << bit))
+            {
+                for (int i = 0; i < 4; i++)
+                {
+                    jumped[i] ^= random.state[i];
+                }
+            }
+
+            nextRandom(random);
+        }
+    }
+
+    for (int i = 0; i < 4; i++)
+    {
+        random.state[i] = jumped[i];
+    }
+}
@@ -0,0 +1,71 @@
+#include "rect_batch.h"
+#include "trace.h"
+
+void createRectBatch(RectBatch &batch)
+{
+    batch.totalRects = 0;
+
+    for (int i = 0; i < MAX_BATCH_RECTS; i++)
+    {
+        int *indices = batch.indices + i * 6;
+        int firstVertex = i * 4;
+
+        // two triangles: top left, top right, bottom right and top left, bottom right, bottom left.
+        indices[0] = firstVertex;
+        indices[1] = firstVertex + 1;
+        indices[2] = firstVertex + 2;
+        indices[3] = firstVertex;
+        indices[4] = firstVertex + 2;
+        indices[5] = firstVertex + 3;
+    }
+}
+
+void addRect(RectBatch &batch, const SDL_Rect &rect, SDL_Color color)
+{
+    SDL_FRect textureRect = {0, 0, 0, 0};
+    addTexturedRect(batch, rect, textureRect, color);
+}
+
+void addTexturedRect(RectBatch &batch, const SDL_Rect &rect, const SDL_FRect &textureRect, SDL_Color color)
+{
+    if (batch.totalRects == MAX_BATCH_RECTS)
+    {
+        return;
+    }
+
+    SDL_Vertex *vertices = batch.vertices + batch.totalRects * 4;
+
+    float left = (float)rect.x;
+    float top = (float)rect.y;
+    float right = (float)(rect.x + rect.w);
+    float bottom = (float)(rect.y + rect.h);
+
+    float textureLeft = textureRect.x;
+    float textureTop = textureRect.y;
+    float textureRight = textureRect.x + textureRect.w;
+    float textureBottom = textureRect.y + textureRect.h;
+
+    vertices[0] = {{left, top}, color, {textureLeft, textureTop}};
+    vertices[1] = {{right, top}, color, {textureRight, textureTop}};
+    vertices[2] = {{right, bottom}, color, {textureRight, textureBottom}};
+    vertices[3] = {{left, bottom}, color, {textureLeft, textureBottom}};
+
+    batch.totalRects++;
+}
+
+void drawRectBatch(SDL_Renderer *renderer, RectBatch &batch)
+{
+    drawRectBatch(renderer, batch, NULL);
+}
+
+void drawRectBatch(SDL_Renderer *renderer, RectBatch &batch, SDL_Texture *texture)
+{
+    TRACE_ZONE("drawRectBatch");
+
+    if (batch.totalRects > 0)
+    {
+        SDL_RenderGeometry(renderer, texture, batch.vertices, batch.totalRects * 4, batch.indices, batch.totalRects * 6);
+    }
+
+    batch.totalRects = 0;
+}
@@ -0,0 +1,257 @@
+#include "replay.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#define makeDirectory(path) _mkdir(path)
+#else
+#include <sys/stat.h>
+#define makeDirectory(path) mkdir(path, 0755)
+#endif
+
+int writeVarint(uint8_t *bytes, uint64_t value)
+{
+    int totalBytes = 0;
+
+    while (value >= 0x80)
+    {
+        bytes[totalBytes++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+
+    bytes[totalBytes++] = (uint8_t)value;
+
+    return totalBytes;
+}
+
+int writeFixed64(uint8_t *bytes, uint64_t value)
+{
+    for (int i = 0; i < 8; i++)
+    {
+        bytes[i] = (uint8_t)(value >> (i * 8));
+    }
+
+    return 8;
+}
+
+bool readVarint(const uint8_t *&bytes, const uint8_t *end, uint64_t &value)
+{
+    value = 0;
+
+    for (int i = 0; i < MAX_VARINT_BYTES && bytes < end; i++)
+    {
+        uint8_t byte = *bytes++;
+        value |= (uint64_t)(byte & 0x7F) << (i * 7);
+
+        if (byte < 0x80)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool readFixed64(const uint8_t *&bytes, const uint8_t *end, uint64_t &value)
+{
+    if (end - bytes < 8)
+    {
+        return false;
+    }
+
+    value = 0;
+
+    for (int i = 0; i < 8; i++)
+    {
+        value |= (uint64_t)bytes[i] << (i * 8);
+    }
+
+    bytes += 8;
+
+    return true;
+}
+
+void startReplay(Replay &replay, const GameState &state)
+{
+    replay.seed = state.seed;
+    replay.previewDepth = state.queue.depth;
+    replay.gravityTicks = GRAVITY_TICKS;
+    replay.lastTick = 0;
+    replay.totalActions = 0;
+    replay.totalBytes = 0;
+    replay.isTruncated = false;
+    replay.isFinished = false;
+}
+
+bool saveReplay(Replay &replay, const GameState &state, const char *directory)
+{
+    replay.isFinished = true;
+
+    uint8_t header[64];
+    int headerBytes = writeVarint(header, REPLAY_MAGIC);
+    headerBytes += writeVarint(header + headerBytes, REPLAY_VERSION);
+    headerBytes += writeFixed64(header + headerBytes, replay.seed);
+    headerBytes += writeVarint(header + headerBytes, replay.previewDepth);
+    headerBytes += writeVarint(header + headerBytes, replay.gravityTicks);
+    headerBytes += writeVarint(header + headerBytes, replay.totalActions);
+
+    uint8_t footer[64];
+    int footerBytes = writeVarint(footer, state.totalTicks);
+    footerBytes += writeVarint(footer + footerBytes, state.score);
+    footerBytes += writeVarint(footer + footerBytes, state.totalLines);
+    footerBytes += writeVarint(footer + footerBytes, state.totalPieces);
+    footer[footerBytes++] = replay.isTruncated;
+    footerBytes += writeFixed64(footer + footerBytes, getGameHash(state));
+
+    // the directory may already be there, only the fopen below can fail for real.
+    makeDirectory(directory);
+
+    char filePath[512];
+    snprintf(filePath, sizeof(filePath), "%s/%016llx.replay", directory, (unsigned long long)replay.seed);
+
+    FILE *file = fopen(filePath, "wb");
+
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    bool isWritten = fwrite(header, 1, headerBytes, file) == (size_t)headerBytes &&
+                     fwrite(replay.bytes, 1, replay.totalBytes, file) == (size_t)replay.totalBytes &&
+                     fwrite(footer, 1, footerBytes, file) == (size_t)footerBytes;
+
+    return fclose(file) == 0 && isWritten;
+}
+
+const char *REPLAY_STATUS_NAMES[TOTAL_REPLAY_STATUSES] = {"valid", "corrupt", "unsupported", "truncated", "mismatch"};
+
+const char *getReplayStatusName(ReplayStatus status)
+{
+    return REPLAY_STATUS_NAMES[status];
+}
+
+ReplayStatus readReplay(Replay &replay, ReplayResult &result, const uint8_t *bytes, int totalBytes)
+{
+    const uint8_t *end = bytes + totalBytes;
+    uint64_t magic, version, previewDepth, gravityTicks, totalActions;
+
+    if (!readVarint(bytes, end, magic) || magic != REPLAY_MAGIC || !readVarint(bytes, end, version))
+    {
+        return REPLAY_CORRUPT;
+    }
+
+    if (version != REPLAY_VERSION)
+    {
+        return REPLAY_UNSUPPORTED;
+    }
+
+    if (!readFixed64(bytes, end, replay.seed) || !readVarint(bytes, end, previewDepth) || !readVarint(bytes, end, gravityTicks) ||
+        !readVarint(bytes, end, totalActions))
+    {
+        return REPLAY_CORRUPT;
+    }
+
+    if (previewDepth < MIN_PREVIEW_DEPTH || previewDepth > MAX_PREVIEW_DEPTH || gravityTicks != GRAVITY_TICKS)
+    {
+        return REPLAY_UNSUPPORTED;
+    }
+
+    // every record takes at least one byte, so this also keeps totalActions in range.
+    const uint8_t *records = bytes;
+    uint64_t record;
+
+    for (uint64_t i = 0; i < totalActions; i++)
+    {
+        if (!readVarint(bytes, end, record))
+        {
+            return REPLAY_CORRUPT;
+        }
+    }
+
+    int totalRecordBytes = (int)(bytes - records);
+
+    if (totalRecordBytes > MAX_REPLAY_BYTES)
+    {
+        return REPLAY_CORRUPT;
+    }
+
+    uint64_t score, totalLines, totalPieces;
+
+    if (!readVarint(bytes, end, result.totalTicks) || !readVarint(bytes, end, score) || !readVarint(bytes, end, totalLines) ||
+        !readVarint(bytes, end, totalPieces) || bytes == end)
+    {
+        return REPLAY_CORRUPT;
+    }
+
+    replay.isTruncated = *bytes++ != 0;
+
+    if (!readFixed64(bytes, end, result.gameHash) || bytes != end)
+    {
+        return REPLAY_CORRUPT;
+    }
+
+    result.score = (int)score;
+    result.totalLines = (int)totalLines;
+    result.totalPieces = (int)totalPieces;
+
+    replay.previewDepth = (int)previewDepth;
+    replay.gravityTicks = (int)gravityTicks;
+    replay.totalActions = (int)totalActions;
+    replay.totalBytes = totalRecordBytes;
+    replay.lastTick = 0;
+    replay.isFinished = true;
+    memcpy(replay.bytes, records, totalRecordBytes);
+
+    return replay.isTruncated ? REPLAY_TRUNCATED : REPLAY_VALID;
+}
+
+ReplayStatus verifyReplay(const Replay &replay, const ReplayResult &result, GameState &state)
+{
+    state.queue.depth = replay.previewDepth;
+    resetGame(state, replay.seed);
+
+    const uint8_t *records = replay.bytes;
+    const uint8_t *end = replay.bytes + replay.totalBytes;
+    uint64_t tick = 0;
+
+    for (int i = 0; i < replay.totalActions; i++)
+    {
+        uint64_t record;
+
+        if (!readVarint(records, end, record))
+        {
+            return REPLAY_CORRUPT;
+        }
+
+        tick += record >> REPLAY_ACTION_BITS;
+        int action = record & ((1 << REPLAY_ACTION_BITS) - 1);
+
+        if (action > ACTION_RIGHT_WALL)
+        {
+            return REPLAY_CORRUPT;
+        }
+
+        updateGameUntil(state, tick);
+
+        // the recording stops at the game over, an action after it was not played.
+        if (state.isGameOver)
+        {
+            return REPLAY_MISMATCH;
+        }
+
+        applyAction(state, (Action)action);
+        clearEvents(state);
+    }
+
+    updateGameUntil(state, result.totalTicks);
+    clearEvents(state);
+
+    if (state.totalTicks != result.totalTicks || state.score != result.score || state.totalLines != result.totalLines ||
+        state.totalPieces != result.totalPieces || getGameHash(state) != result.gameHash)
+    {
+        return REPLAY_MISMATCH;
+    }
+
+    return REPLAY_VALID;
+}
@@ -1,7 +1,10 @@
 #include "sdl_assets_loader.h"
+#include "trace.h"
 
 Sprite loadSprite(SDL_Renderer *renderer, const char *filePath, int positionX, int positionY)
 {
+    TRACE_ZONE("loadSprite");
+
     SDL_Rect bounds = {positionX, positionY, 0, 0};
 
     SDL_Texture *texture = IMG_LoadTexture(renderer, filePath);
@@ -23,6 +26,8 @@ void renderSprite(SDL_Renderer *renderer, Sprite &sprite)
 
 Mix_Chunk *loadSound(const char *filePath)
 {
+    TRACE_ZONE("loadSound");
+
     Mix_Chunk *sound = nullptr;
 
     sound = Mix_LoadWAV(filePath);
@@ -36,6 +41,8 @@ Mix_Chunk *loadSound(const char *filePath)
 
 Mix_Music *loadMusic(const char *filePath)
 {
+    TRACE_ZONE("loadMusic");
+
     Mix_Music *music = nullptr;
 
     music = Mix_LoadMUS(filePath);
@@ -49,6 +56,8 @@ Mix_Music *loadMusic(const char *filePath)
 
 void updateTextureText(SDL_Texture *&texture, const char *text, TTF_Font *&fontSquare, SDL_Renderer *renderer)
 {
+    TRACE_ZONE("updateTextureText");
+
     SDL_Color fontColor = {255, 255, 255};
 
     if (fontSquare == nullptr)
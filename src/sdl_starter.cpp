@@ -49,12 +49,81 @@ int startSDL(SDL_Window *window, SDL_Renderer *renderer)
     return 0;
 }
 
-void capFrameRate(Uint32 frameStartTime)
+int getDisplayRefreshRate(SDL_Window *window)
 {
-    Uint32 frameTime = SDL_GetTicks() - frameStartTime;
+    SDL_DisplayMode displayMode;
 
-    if (frameTime < 1000 / FRAME_RATE)
+    if (SDL_GetWindowDisplayMode(window, &displayMode) < 0 || displayMode.refresh_rate <= 0)
     {
-        SDL_Delay(1000 / FRAME_RATE - frameTime);
+        return FRAME_RATE;
     }
+
+    return displayMode.refresh_rate;
+}
+
+void startFramePacer(FramePacer &pacer, int frameRate)
+{
+    pacer.frequency = SDL_GetPerformanceFrequency();
+    pacer.frameTicks = pacer.frequency / frameRate;
+    pacer.nextDeadline = SDL_GetPerformanceCounter() + pacer.frameTicks;
+    pacer.frameRate = frameRate;
+    pacer.totalLateness = 0;
+    pacer.maxLateness = 0;
+    pacer.totalFrames = 0;
+    pacer.missedFrames = 0;
+}
+
+void waitNextFrame(FramePacer &pacer)
+{
+    Uint64 spinTicks = (Uint64)(pacer.frequency * PACER_SPIN_MILLISECONDS / 1000);
+    Uint64 now = SDL_GetPerformanceCounter();
+
+    if (now + spinTicks < pacer.nextDeadline)
+    {
+        Uint64 sleepTicks = pacer.nextDeadline - now - spinTicks;
+        SDL_Delay((Uint32)(sleepTicks * 1000 / pacer.frequency));
+    }
+
+    now = SDL_GetPerformanceCounter();
+
+    while (now < pacer.nextDeadline)
+    {
+        SDL_CPUPauseInstruction();
+        now = SDL_GetPerformanceCounter();
+    }
+
+    Uint64 lateness = now - pacer.nextDeadline;
+
+    pacer.totalFrames++;
+    pacer.totalLateness += lateness;
+    pacer.maxLateness = lateness > pacer.maxLateness ? lateness : pacer.maxLateness;
+
+    // a slow frame doesn't make the next ones shorter to catch up.
+    if (lateness >= pacer.frameTicks)
+    {
+        pacer.missedFrames++;
+        pacer.nextDeadline = now;
+    }
+
+    pacer.nextDeadline += pacer.frameTicks;
+}
+
+void restartFramePacer(FramePacer &pacer)
+{
+    pacer.nextDeadline = SDL_GetPerformanceCounter() + pacer.frameTicks;
+}
+
+void printFramePacer(const FramePacer &pacer, FILE *file)
+{
+    if (pacer.totalFrames == 0)
+    {
+        return;
+    }
+
+    double microseconds = 1000000.0 / pacer.frequency;
+
+    fprintf(file, "frame pacer at %d fps over %d frames: %.1f us mean lateness, %.1f us max, %d missed frames\n",
+            pacer.frameRate, pacer.totalFrames, pacer.totalLateness * microseconds / pacer.totalFrames, pacer.maxLateness * microseconds, pacer.missedFrames);
+
+    fflush(file);
 }
\ No newline at end of file
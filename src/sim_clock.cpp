@@ -0,0 +1,38 @@
+#include "sim_clock.h"
+#include "game_state.h"
+
+void resetSimClock(SimClock &clock, uint64_t frequency, uint64_t now)
+{
+    clock.frequency = frequency;
+    clock.lastTime = now;
+    clock.accumulator = 0;
+    clock.totalTicks = 0;
+}
+
+int advanceSimClock(SimClock &clock, uint64_t now)
+{
+    clock.accumulator += (now - clock.lastTime) * TICKS_PER_SECOND;
+    clock.lastTime = now;
+
+    uint64_t totalTicks = clock.accumulator / clock.frequency;
+    clock.accumulator -= totalTicks * clock.frequency;
+
+    if (totalTicks > MAX_TICKS_PER_FRAME)
+    {
+        totalTicks = MAX_TICKS_PER_FRAME;
+    }
+
+    clock.totalTicks += totalTicks;
+
+    return (int)totalTicks;
+}
+
+void skipSimTime(SimClock &clock, uint64_t now)
+{
+    clock.lastTime = now;
+}
+
+float getSimAlpha(const SimClock &clock)
+{
+    return (float)clock.accumulator / clock.frequency;
+}
@@ -0,0 +1,178 @@
+#include "thread_pool.h"
+
+thread_local ThreadPool *currentPool = nullptr;
+thread_local int currentWorkerIndex = -1;
+
+int getDefaultWorkerCount()
+{
+    int totalWorkers = std::thread::hardware_concurrency();
+
+    if (totalWorkers < 1)
+    {
+        totalWorkers = 1;
+    }
+
+    if (totalWorkers > MAX_WORKERS)
+    {
+        totalWorkers = MAX_WORKERS;
+    }
+
+    return totalWorkers;
+}
+
+bool popTask(WorkerQueue &queue, Task &task, bool isOwner)
+{
+    std::lock_guard<std::mutex> lock(queue.mutex);
+
+    if (queue.tasks.empty())
+    {
+        return false;
+    }
+
+    // the owner keeps working on the newest tasks, thieves take the oldest ones.
+    if (isOwner)
+    {
+        task = queue.tasks.back();
+        queue.tasks.pop_back();
+    }
+    else
+    {
+        task = queue.tasks.front();
+        queue.tasks.pop_front();
+    }
+
+    return true;
+}
+
+bool findTask(ThreadPool &pool, int workerIndex, Task &task)
+{
+    if (popTask(pool.queues[workerIndex], task, true))
+    {
+        return true;
+    }
+
+    int totalQueues = pool.totalWorkers + 1;
+
+    for (int i = 1; i < totalQueues; i++)
+    {
+        int victim = (workerIndex + i) % totalQueues;
+
+        if (popTask(pool.queues[victim], task, false))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void runTask(ThreadPool &pool, Task &task, int workerIndex)
+{
+    pool.queuedTasks--;
+    task.function(task.data, task.taskIndex, workerIndex);
+    pool.unfinishedTasks--;
+}
+
+void runWorker(ThreadPool *pool, int workerIndex)
+{
+    currentPool = pool;
+    currentWorkerIndex = workerIndex;
+
+    while (true)
+    {
+        Task task;
+
+        if (findTask(*pool, workerIndex, task))
+        {
+            runTask(*pool, task, workerIndex);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(pool->sleepMutex);
+        pool->wakeUp.wait(lock, [pool] { return pool->queuedTasks > 0 || pool->isStopping; });
+
+        if (pool->isStopping)
+        {
+            return;
+        }
+    }
+}
+
+void startThreadPool(ThreadPool &pool, int totalWorkers)
+{
+    if (totalWorkers > MAX_WORKERS)
+    {
+        totalWorkers = MAX_WORKERS;
+    }
+
+    pool.totalWorkers = totalWorkers;
+    pool.queuedTasks = 0;
+    pool.unfinishedTasks = 0;
+    pool.nextQueue = 0;
+    pool.isStopping = false;
+
+    for (int i = 0; i < totalWorkers; i++)
+    {
+        pool.threads[i] = std::thread(runWorker, &pool, i);
+    }
+}
+
+void submitTask(ThreadPool &pool, TaskFunction function, void *data, int taskIndex)
+{
+    // tasks submitted from a worker stay in its own queue, the rest are spread over all the workers.
+    int queueIndex = currentPool == &pool ? currentWorkerIndex : pool.nextQueue++ % (pool.totalWorkers + 1);
+
+    pool.unfinishedTasks++;
+    pool.queuedTasks++;
+
+    {
+        std::lock_guard<std::mutex> lock(pool.queues[queueIndex].mutex);
+        pool.queues[queueIndex].tasks.push_back({function, data, taskIndex});
+    }
+
+    std::lock_guard<std::mutex> lock(pool.sleepMutex);
+    pool.wakeUp.notify_one();
+}
+
+void waitForTasks(ThreadPool &pool)
+{
+    // the waiting thread works as one more worker until everything is done.
+    int workerIndex = pool.totalWorkers;
+
+    ThreadPool *previousPool = currentPool;
+    int previousWorkerIndex = currentWorkerIndex;
+    currentPool = &pool;
+    currentWorkerIndex = workerIndex;
+
+    while (pool.unfinishedTasks > 0)
+    {
+        Task task;
+
+        if (findTask(pool, workerIndex, task))
+        {
+            runTask(pool, task, workerIndex);
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    currentPool = previousPool;
+    currentWorkerIndex = previousWorkerIndex;
+}
+
+void stopThreadPool(ThreadPool &pool)
+{
+    {
+        std::lock_guard<std::mutex> lock(pool.sleepMutex);
+        pool.isStopping = true;
+    }
+
+    pool.wakeUp.notify_all();
+
+    for (int i = 0; i < pool.totalWorkers; i++)
+    {
+        pool.threads[i].join();
+    }
+}
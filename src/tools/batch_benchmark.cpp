@@ -0,0 +1,93 @@
+#include "batch_sim.h"
+#include <chrono>
+#include <stdio.h>
+
+const int TOTAL_TICKS = 20000;
+
+// cheap input noise, so the blocks don't pile up in the middle and every game lasts a while.
+uint32_t nextInput(uint32_t &state)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+
+    return state;
+}
+
+// the whole loop, and only tickGameBatch without the input noise and the moves it makes.
+typedef struct
+{
+    double totalTicksPerSecond;
+    double tickOnlyTicksPerSecond;
+} BatchResult;
+
+BatchResult measureGameTicksPerSecond(int totalGames)
+{
+    GameBatch batch;
+    createGameBatch(batch, totalGames, 1);
+
+    uint32_t inputState = 2463534242u;
+    int ticks = TOTAL_TICKS;
+
+    // keeping the total work similar for every batch size.
+    if (totalGames > 64)
+    {
+        ticks = TOTAL_TICKS * 64 / totalGames;
+    }
+
+    std::chrono::duration<double> tickElapsed(0);
+    auto start = std::chrono::steady_clock::now();
+
+    for (int tick = 0; tick < ticks; tick++)
+    {
+        for (int game = 0; game < totalGames; game++)
+        {
+            uint32_t input = nextInput(inputState) & 7;
+
+            if (input == 0)
+            {
+                moveBatchBlock(batch, game, -1);
+            }
+
+            else if (input == 1)
+            {
+                moveBatchBlock(batch, game, 1);
+            }
+
+            else if (input == 2)
+            {
+                rotateBatchBlock(batch, game);
+            }
+
+            if (batch.isGameOver[game])
+            {
+                resetBatchGame(batch, game, nextInput(inputState));
+            }
+        }
+
+        auto tickStart = std::chrono::steady_clock::now();
+        tickGameBatch(batch);
+        tickElapsed += std::chrono::steady_clock::now() - tickStart;
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    BatchResult result;
+    result.totalTicksPerSecond = (double)ticks * totalGames / elapsed.count();
+    result.tickOnlyTicksPerSecond = (double)ticks * totalGames / tickElapsed.count();
+
+    return result;
+}
+
+int main()
+{
+    const int batchSizes[] = {1, 64, 4096};
+
+    for (int totalGames : batchSizes)
+    {
+        BatchResult result = measureGameTicksPerSecond(totalGames);
+        printf("N = %4d: %.0f game-ticks/second, %.0f in tickGameBatch alone\n", totalGames, result.totalTicksPerSecond, result.tickOnlyTicksPerSecond);
+    }
+
+    return 0;
+}
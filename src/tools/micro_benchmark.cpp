@@ -0,0 +1,258 @@
+#include "bot.h"
+#include "collision.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+const int TOTAL_FIXTURES = 256;
+const int TOTAL_REPEATS = 7;
+const int ITERATIONS_PER_REPEAT = 1 << 14;
+
+typedef struct
+{
+    Board boards[TOTAL_FIXTURES];
+    Block blocks[TOTAL_FIXTURES];
+    GameState games[TOTAL_FIXTURES];
+    Block placements[TOTAL_FIXTURES];
+} Fixtures;
+
+typedef struct
+{
+    const char *name;
+    double nanoseconds;
+    long long iterations;
+} BenchmarkResult;
+
+Fixtures fixtures;
+GameState scratchGame;
+Board scratchBoard;
+volatile uint64_t sink;
+
+// a random stack of cells that leaves every row with at least one hole, so nothing is cleared by accident.
+void fillRandomBoard(Board &board, Random &random)
+{
+    clearBoard(board);
+
+    int height = randomRange(random, 0, TOTAL_ROWS - 6);
+
+    for (int row = TOTAL_ROWS - height; row < TOTAL_ROWS; row++)
+    {
+        int hole = randomRange(random, 0, TOTAL_COLUMNS - 1);
+
+        for (int column = 0; column < TOTAL_COLUMNS; column++)
+        {
+            if (column != hole && randomRange(random, 0, 3) != 0)
+            {
+                setCell(board, row, column, randomRange(random, 1, TOTAL_BLOCK_TYPES));
+            }
+        }
+    }
+}
+
+void fillFullRows(Board &board, Random &random, int totalFullRows)
+{
+    int filledRows = 0;
+
+    while (filledRows < totalFullRows)
+    {
+        int row = randomRange(random, TOTAL_ROWS - 8, TOTAL_ROWS - 1);
+
+        if (isRowFull(board, row))
+        {
+            continue;
+        }
+
+        for (int column = 0; column < TOTAL_COLUMNS; column++)
+        {
+            setCell(board, row, column, randomRange(random, 1, TOTAL_BLOCK_TYPES));
+        }
+
+        filledRows++;
+    }
+}
+
+void createFixtures(uint64_t seed, int totalFullRows)
+{
+    Random random;
+    seedRandom(random, seed);
+
+    for (int i = 0; i < TOTAL_FIXTURES; i++)
+    {
+        fillRandomBoard(fixtures.boards[i], random);
+        fillFullRows(fixtures.boards[i], random, totalFullRows);
+
+        Block &block = fixtures.blocks[i];
+        block = createBlock(randomRange(random, 1, TOTAL_BLOCK_TYPES));
+        block.rotationState = randomRange(random, 0, BLOCK_ROTATIONS[block.id] - 1);
+        block.rowOffset = randomRange(random, -2, TOTAL_ROWS - 1);
+        block.columnOffset = randomRange(random, -2, TOTAL_COLUMNS - 1);
+
+        // a game with the block resting on the stack, so lockBlock has something real to lock.
+        GameState &game = fixtures.games[i];
+        game.queue.depth = MIN_PREVIEW_DEPTH;
+        resetGame(game, nextRandom(random));
+        game.board = fixtures.boards[i];
+        game.currentBlock.rowOffset = findLandingRow(game.board, game.currentBlock);
+
+        // the last placement usually needs the longest path.
+        static PlacementList placements;
+        generatePlacements(fixtures.boards[i], createBlock(block.id), placements);
+        fixtures.placements[i] = placements.totalPlacements > 0 ? placements.placements[placements.totalPlacements - 1].block : createBlock(block.id);
+    }
+}
+
+// the fastest of a few runs, every run goes over all the fixtures many times.
+template <typename Operation>
+BenchmarkResult measure(const char *name, Operation operation)
+{
+    BenchmarkResult result = {name, 0, 0};
+
+    for (int repeat = 0; repeat < TOTAL_REPEATS; repeat++)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        for (int i = 0; i < ITERATIONS_PER_REPEAT; i++)
+        {
+            operation(i & (TOTAL_FIXTURES - 1));
+        }
+
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        double nanoseconds = elapsed.count() / ITERATIONS_PER_REPEAT;
+
+        if (repeat == 0 || nanoseconds < result.nanoseconds)
+        {
+            result.nanoseconds = nanoseconds;
+        }
+
+        result.iterations += ITERATIONS_PER_REPEAT;
+    }
+
+    return result;
+}
+
+void printResults(FILE *file, uint64_t seed, const BenchmarkResult *results, int totalResults)
+{
+    fprintf(file, "{\n  \"seed\": %llu,\n  \"fixtures\": %d,\n  \"benchmarks\": [\n", (unsigned long long)seed, TOTAL_FIXTURES);
+
+    for (int i = 0; i < totalResults; i++)
+    {
+        fprintf(file, "    {\"name\": \"%s\", \"ns_per_op\": %.2f, \"iterations\": %lld}%s\n", results[i].name, results[i].nanoseconds, results[i].iterations, i + 1 < totalResults ? "," : "");
+    }
+
+    fprintf(file, "  ]\n}\n");
+}
+
+int main(int argc, char *args[])
+{
+    uint64_t seed = 1;
+
+    if (argc > 1)
+    {
+        seed = strtoull(args[1], NULL, 10);
+    }
+
+    BenchmarkResult results[32];
+    int totalResults = 0;
+
+    createFixtures(seed, 0);
+
+    results[totalResults++] = measure("getCellPositions", [](int i) {
+        CellOffset cells[CELLS_PER_BLOCK];
+        getCellPositions(fixtures.blocks[i], cells);
+        sink += cells[3].row;
+    });
+
+    results[totalResults++] = measure("blockFits", [](int i) {
+        sink += blockFits(fixtures.boards[i], fixtures.blocks[i]);
+    });
+
+    // the old isBlockOutside test is the bounds part of pieceFits now, so this one only uses offsets outside of the board.
+    results[totalResults++] = measure("pieceFits_outside", [](int i) {
+        const Block &block = fixtures.blocks[i];
+        sink += pieceFits(fixtures.boards[i], block.id, block.rotationState, block.rowOffset, -4 - (i & 3));
+    });
+
+    results[totalResults++] = measure("findLandingRow", [](int i) {
+        Block block = fixtures.games[i].currentBlock;
+        block.rowOffset = 0;
+        sink += findLandingRow(fixtures.boards[i], block);
+    });
+
+    results[totalResults++] = measure("rotateBlock", [](int i) {
+        GameState &game = fixtures.games[i];
+        rotateBlock(game);
+        clearEvents(game);
+        sink += game.currentBlock.rotationState;
+    });
+
+    // the copies are the cost of restoring the fixture, they are there to be subtracted from the ones below.
+    results[totalResults++] = measure("copyBoard", [](int i) {
+        scratchBoard = fixtures.boards[i];
+        sink += scratchBoard.rows[TOTAL_ROWS - 1];
+    });
+
+    results[totalResults++] = measure("copyGameState", [](int i) {
+        scratchGame = fixtures.games[i];
+        sink += scratchGame.score;
+    });
+
+    const char *clearNames[] = {"clearFullRows_0", "clearFullRows_1", "clearFullRows_2", "clearFullRows_3", "clearFullRows_4"};
+
+    for (int totalFullRows = 0; totalFullRows <= 4; totalFullRows++)
+    {
+        createFixtures(seed, totalFullRows);
+
+        results[totalResults++] = measure(clearNames[totalFullRows], [](int i) {
+            scratchBoard = fixtures.boards[i];
+            sink += clearFullRows(scratchBoard);
+        });
+    }
+
+    createFixtures(seed, 0);
+
+    results[totalResults++] = measure("takePiece", [](int i) {
+        GameState &game = fixtures.games[i];
+        sink += takePiece(game.queue, game.random);
+    });
+
+    results[totalResults++] = measure("lockBlock", [](int i) {
+        scratchGame = fixtures.games[i];
+        lockBlock(scratchGame);
+        sink += scratchGame.totalPieces;
+    });
+
+    results[totalResults++] = measure("generatePlacements", [](int i) {
+        static PlacementList placements;
+        generatePlacements(fixtures.boards[i], createBlock(fixtures.blocks[i].id), placements);
+        sink += placements.totalPlacements;
+    });
+
+    results[totalResults++] = measure("findPlacementPath", [](int i) {
+        PlacementPath path;
+        sink += findPlacementPath(fixtures.boards[i], createBlock(fixtures.blocks[i].id), fixtures.placements[i], path) ? path.length : 0;
+    });
+
+    results[totalResults++] = measure("getBoardFeatures", [](int i) {
+        BoardFeatures features;
+        getBoardFeatures(fixtures.boards[i].rows, 0, features);
+        sink += features.holes;
+    });
+
+    printResults(stdout, seed, results, totalResults);
+
+    if (argc > 2)
+    {
+        FILE *file = fopen(args[2], "w");
+
+        if (file == NULL)
+        {
+            printf("can't write %s\n", args[2]);
+            return 1;
+        }
+
+        printResults(file, seed, results, totalResults);
+        fclose(file);
+    }
+
+    return 0;
+}
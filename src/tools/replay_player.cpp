@@ -0,0 +1,209 @@
+#include "replay.h"
+#include "thread_pool.h"
+#include "trace.h"
+#include <chrono>
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+const int REPLAYS_PER_TASK = 16;
+// the biggest replay there can be: the records and room for the header and the footer.
+const int MAX_REPLAY_FILE_BYTES = MAX_REPLAY_BYTES + 256;
+
+// everything a worker needs to check one replay, kept from one replay to the next.
+typedef struct
+{
+    Replay replay;
+    GameState game;
+    std::vector<uint8_t> fileBytes;
+} ReplayWorker;
+
+typedef struct
+{
+    long long totalReplays;
+    long long totalActions;
+    long long totalTicks;
+    long long totalStatuses[TOTAL_REPLAY_STATUSES];
+} PlayerStats;
+
+ThreadPool pool;
+std::vector<std::string> filePaths;
+std::vector<ReplayWorker> workers;
+WorkerShard<PlayerStats> shards[MAX_WORKERS + 1];
+
+// false when the file can't be read, or is too big to be a replay.
+bool readFile(const char *filePath, std::vector<uint8_t> &bytes)
+{
+    FILE *file = fopen(filePath, "rb");
+
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    bytes.resize(MAX_REPLAY_FILE_BYTES + 1);
+    size_t totalBytes = fread(bytes.data(), 1, bytes.size(), file);
+    fclose(file);
+
+    bytes.resize(totalBytes);
+
+    return totalBytes <= (size_t)MAX_REPLAY_FILE_BYTES;
+}
+
+ReplayStatus checkReplay(ReplayWorker &worker, const char *filePath, ReplayResult &result)
+{
+    if (!readFile(filePath, worker.fileBytes))
+    {
+        return REPLAY_CORRUPT;
+    }
+
+    ReplayStatus status = readReplay(worker.replay, result, worker.fileBytes.data(), (int)worker.fileBytes.size());
+
+    if (status != REPLAY_VALID)
+    {
+        return status;
+    }
+
+    return verifyReplay(worker.replay, result, worker.game);
+}
+
+void checkReplays(void *data, int taskIndex, int workerIndex)
+{
+    TRACE_ZONE("checkReplays");
+
+    ReplayWorker &worker = workers[workerIndex];
+    PlayerStats &stats = shards[workerIndex].stats;
+
+    int firstReplay = taskIndex * REPLAYS_PER_TASK;
+    int lastReplay = firstReplay + REPLAYS_PER_TASK < (int)filePaths.size() ? firstReplay + REPLAYS_PER_TASK : (int)filePaths.size();
+
+    for (int i = firstReplay; i < lastReplay; i++)
+    {
+        ReplayResult result;
+        ReplayStatus status = checkReplay(worker, filePaths[i].c_str(), result);
+
+        stats.totalReplays++;
+        stats.totalStatuses[status]++;
+
+        if (status == REPLAY_VALID)
+        {
+            stats.totalActions += worker.replay.totalActions;
+            stats.totalTicks += result.totalTicks;
+        }
+        else
+        {
+            printf("%s: %s\n", filePaths[i].c_str(), getReplayStatusName(status));
+        }
+    }
+}
+
+bool endsWith(const char *text, const char *suffix)
+{
+    size_t textLength = strlen(text);
+    size_t suffixLength = strlen(suffix);
+
+    return textLength >= suffixLength && strcmp(text + textLength - suffixLength, suffix) == 0;
+}
+
+int playReplay(const char *filePath)
+{
+    workers.resize(1);
+
+    ReplayResult result;
+    auto start = std::chrono::steady_clock::now();
+    ReplayStatus status = checkReplay(workers[0], filePath, result);
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+
+    const GameState &game = workers[0].game;
+
+    printf("%s: %s in %.1f us\n", filePath, getReplayStatusName(status), elapsed.count());
+
+    if (status == REPLAY_VALID || status == REPLAY_MISMATCH)
+    {
+        printf("seed %016llx, %d actions\n", (unsigned long long)workers[0].replay.seed, workers[0].replay.totalActions);
+        printf("recorded: ticks %llu, score %d, lines %d, pieces %d\n", (unsigned long long)result.totalTicks, result.score, result.totalLines, result.totalPieces);
+        printf("played:   ticks %llu, score %d, lines %d, pieces %d\n", (unsigned long long)game.totalTicks, game.score, game.totalLines, game.totalPieces);
+    }
+
+    return status == REPLAY_VALID ? 0 : 1;
+}
+
+int main(int argc, char *args[])
+{
+    if (argc < 2)
+    {
+        printf("usage: replay_player <file.replay | directory> [threads]\n");
+        return 1;
+    }
+
+    DIR *directory = opendir(args[1]);
+
+    if (directory == NULL)
+    {
+        return playReplay(args[1]);
+    }
+
+    for (dirent *entry = readdir(directory); entry != NULL; entry = readdir(directory))
+    {
+        if (endsWith(entry->d_name, ".replay"))
+        {
+            filePaths.push_back(std::string(args[1]) + "/" + entry->d_name);
+        }
+    }
+
+    closedir(directory);
+
+    int totalWorkers = argc > 2 ? atoi(args[2]) : getDefaultWorkerCount();
+
+    if (totalWorkers < 1)
+    {
+        printf("usage: replay_player <file.replay | directory> [threads]\n");
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    startThreadPool(pool, totalWorkers);
+    workers.resize(pool.totalWorkers + 1);
+
+    int totalTasks = ((int)filePaths.size() + REPLAYS_PER_TASK - 1) / REPLAYS_PER_TASK;
+
+    for (int taskIndex = 0; taskIndex < totalTasks; taskIndex++)
+    {
+        submitTask(pool, checkReplays, NULL, taskIndex);
+    }
+
+    waitForTasks(pool);
+    stopThreadPool(pool);
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    TRACE_WRITE("trace.json");
+
+    PlayerStats total = {};
+
+    for (int i = 0; i <= pool.totalWorkers; i++)
+    {
+        total.totalReplays += shards[i].stats.totalReplays;
+        total.totalActions += shards[i].stats.totalActions;
+        total.totalTicks += shards[i].stats.totalTicks;
+
+        for (int status = 0; status < TOTAL_REPLAY_STATUSES; status++)
+        {
+            total.totalStatuses[status] += shards[i].stats.totalStatuses[status];
+        }
+    }
+
+    printf("replays: %lld, threads: %d, seconds: %.3f, replays/second: %.0f\n", total.totalReplays, pool.totalWorkers, elapsed.count(), total.totalReplays / elapsed.count());
+    printf("actions/second: %.0f, ticks/second: %.0f\n", total.totalActions / elapsed.count(), total.totalTicks / elapsed.count());
+
+    for (int status = 0; status < TOTAL_REPLAY_STATUSES; status++)
+    {
+        printf("%s: %lld\n", getReplayStatusName((ReplayStatus)status), total.totalStatuses[status]);
+    }
+
+    return total.totalStatuses[REPLAY_VALID] == total.totalReplays ? 0 : 1;
+}
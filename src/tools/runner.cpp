@@ -0,0 +1,238 @@
+#include "beam_search.h"
+#include "thread_pool.h"
+#include "trace.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+const int GAMES_PER_TASK = 64;
+const int MAX_GAME_TICKS = 1000000;
+// the beam policy sees this many blocks of the preview, and searches the current block and all of them.
+const int BEAM_PREVIEW_DEPTH = 3;
+
+typedef struct
+{
+    uint64_t baseSeed;
+    int totalGames;
+    bool isBotPlaying;
+    // every game already runs in a worker, so the search of each game stays in its thread.
+    SearchConfig search;
+    // one jumped stream per task, the seed of every game is drawn from the stream of its task.
+    std::vector<Random> taskRandoms;
+} RunnerConfig;
+
+typedef struct
+{
+    long long totalGames;
+    long long totalScore;
+    long long totalLines;
+    long long totalPieces;
+    long long totalTicks;
+    int maxScore;
+} RunnerStats;
+
+ThreadPool pool;
+// shared by all the workers, they all play with the same weights.
+TranspositionTable table;
+WorkerShard<RunnerStats> shards[MAX_WORKERS + 1];
+
+void chooseTarget(GameState &game, Random &inputRandom, int &targetRotation, int &targetColumn)
+{
+    targetRotation = randomRange(inputRandom, 0, BLOCK_ROTATIONS[game.currentBlock.id] - 1);
+    targetColumn = randomRange(inputRandom, -1, TOTAL_COLUMNS - 2);
+}
+
+// every block goes to a random rotation and column and then it's dropped.
+int playRandomGame(GameState &game, uint64_t seed)
+{
+    Random inputRandom;
+    seedRandom(inputRandom, ~seed);
+
+    int lockedPieces = 0;
+    int targetRotation = 0;
+    int targetColumn = 0;
+
+    resetGame(game, seed);
+    chooseTarget(game, inputRandom, targetRotation, targetColumn);
+
+    int tick = 0;
+
+    for (; tick < MAX_GAME_TICKS && !game.isGameOver; tick++)
+    {
+        if (game.currentBlock.rotationState != targetRotation)
+        {
+            rotateBlock(game);
+        }
+
+        bool hasMoved = false;
+
+        if (game.currentBlock.columnOffset != targetColumn)
+        {
+            hasMoved = moveBlock(game, 0, game.currentBlock.columnOffset < targetColumn ? 1 : -1);
+        }
+
+        if (!hasMoved && game.currentBlock.rotationState == targetRotation)
+        {
+            softDrop(game);
+        }
+
+        tickGame(game);
+        clearEvents(game);
+
+        if (lockedPieces != game.totalPieces)
+        {
+            lockedPieces = game.totalPieces;
+            chooseTarget(game, inputRandom, targetRotation, targetColumn);
+        }
+    }
+
+    return tick;
+}
+
+// the bot drops every block by itself, so there are no gravity ticks and every tick is one bot action.
+int playBotGame(GameState &game, uint64_t seed, const SearchConfig &search)
+{
+    Bot bot;
+    bot.search = search;
+    resetBot(bot);
+
+    game.queue.depth = search.depth > 1 ? search.depth - 1 : MIN_PREVIEW_DEPTH;
+    resetGame(game, seed);
+
+    int tick = 0;
+
+    for (; tick < MAX_GAME_TICKS && !game.isGameOver; tick++)
+    {
+        applyAction(game, getBotAction(bot, game, DEFAULT_BOT_WEIGHTS));
+        clearEvents(game);
+    }
+
+    return tick;
+}
+
+void runGames(void *data, int taskIndex, int workerIndex)
+{
+    TRACE_ZONE("runGames");
+
+    RunnerConfig *config = (RunnerConfig *)data;
+    RunnerStats &stats = shards[workerIndex].stats;
+
+    int firstGame = taskIndex * GAMES_PER_TASK;
+    int lastGame = firstGame + GAMES_PER_TASK < config->totalGames ? firstGame + GAMES_PER_TASK : config->totalGames;
+
+    Random taskRandom = config->taskRandoms[taskIndex];
+    GameState game = {};
+
+    for (int gameIndex = firstGame; gameIndex < lastGame; gameIndex++)
+    {
+        uint64_t seed = nextRandom(taskRandom);
+        int ticks = config->isBotPlaying ? playBotGame(game, seed, config->search) : playRandomGame(game, seed);
+
+        stats.totalGames++;
+        stats.totalScore += game.score;
+        stats.totalLines += game.totalLines;
+        stats.totalPieces += game.totalPieces;
+        stats.totalTicks += ticks;
+
+        if (game.score > stats.maxScore)
+        {
+            stats.maxScore = game.score;
+        }
+    }
+}
+
+int main(int argc, char *args[])
+{
+    RunnerConfig config;
+    config.baseSeed = 1;
+    config.totalGames = 100000;
+    config.isBotPlaying = false;
+    config.search = {1, DEFAULT_BEAM_WIDTH, 0, nullptr, &table};
+
+    int totalWorkers = getDefaultWorkerCount();
+
+    if (argc > 1)
+    {
+        config.totalGames = atoi(args[1]);
+    }
+
+    if (argc > 2)
+    {
+        totalWorkers = atoi(args[2]);
+    }
+
+    if (argc > 3)
+    {
+        config.baseSeed = strtoull(args[3], NULL, 10);
+    }
+
+    if (argc > 4)
+    {
+        config.isBotPlaying = strcmp(args[4], "bot") == 0 || strcmp(args[4], "beam") == 0;
+
+        if (strcmp(args[4], "beam") == 0)
+        {
+            config.search.depth = 1 + BEAM_PREVIEW_DEPTH;
+        }
+    }
+
+    if (config.totalGames < 1 || totalWorkers < 1)
+    {
+        printf("usage: runner [games] [threads] [seed] [random|bot|beam]\n");
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    startThreadPool(pool, totalWorkers);
+
+    int totalTasks = (config.totalGames + GAMES_PER_TASK - 1) / GAMES_PER_TASK;
+
+    Random taskStream;
+    seedRandom(taskStream, config.baseSeed);
+    config.taskRandoms.resize(totalTasks);
+
+    for (int taskIndex = 0; taskIndex < totalTasks; taskIndex++)
+    {
+        config.taskRandoms[taskIndex] = taskStream;
+        jumpRandom(taskStream);
+    }
+
+    for (int taskIndex = 0; taskIndex < totalTasks; taskIndex++)
+    {
+        submitTask(pool, runGames, &config, taskIndex);
+    }
+
+    waitForTasks(pool);
+    stopThreadPool(pool);
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    TRACE_WRITE("trace.json");
+
+    RunnerStats total = {};
+
+    for (int i = 0; i <= pool.totalWorkers; i++)
+    {
+        total.totalGames += shards[i].stats.totalGames;
+        total.totalScore += shards[i].stats.totalScore;
+        total.totalLines += shards[i].stats.totalLines;
+        total.totalPieces += shards[i].stats.totalPieces;
+        total.totalTicks += shards[i].stats.totalTicks;
+
+        if (shards[i].stats.maxScore > total.maxScore)
+        {
+            total.maxScore = shards[i].stats.maxScore;
+        }
+    }
+
+    double totalGames = (double)total.totalGames;
+
+    printf("games: %lld, threads: %d, seconds: %.3f, games/hour: %.0f\n", total.totalGames, pool.totalWorkers, elapsed.count(), totalGames / elapsed.count() * 3600);
+    printf("score: average %.1f, max %d\n", total.totalScore / totalGames, total.maxScore);
+    printf("lines: average %.2f, pieces: average %.1f, game length: average %.1f ticks\n", total.totalLines / totalGames, total.totalPieces / totalGames, total.totalTicks / totalGames);
+
+    return 0;
+}
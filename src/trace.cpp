@@ -0,0 +1,80 @@
+#include "trace.h"
+
+#ifdef ENABLE_TRACING
+
+#include <chrono>
+#include <stdio.h>
+
+thread_local TraceBuffer *currentTraceBuffer = nullptr;
+
+// the buffers are never freed, the threads can finish before the trace is written.
+std::atomic<TraceBuffer *> traceBuffers[MAX_TRACE_THREADS];
+std::atomic<int> totalTraceBuffers(0);
+uint64_t traceStartTime = getTraceTime();
+std::chrono::steady_clock::time_point traceStartClock = std::chrono::steady_clock::now();
+
+TraceBuffer *createTraceBuffer()
+{
+    int threadId = totalTraceBuffers.fetch_add(1);
+
+    if (threadId >= MAX_TRACE_THREADS)
+    {
+        return nullptr;
+    }
+
+    TraceBuffer *buffer = new TraceBuffer;
+    buffer->totalEvents.store(0, std::memory_order_relaxed);
+    buffer->threadId = threadId;
+
+    traceBuffers[threadId].store(buffer, std::memory_order_release);
+    currentTraceBuffer = buffer;
+
+    return buffer;
+}
+
+void writeTraceFile(const char *filePath)
+{
+    FILE *file = fopen(filePath, "w");
+
+    if (file == nullptr)
+    {
+        printf("can't write the trace to %s\n", filePath);
+        return;
+    }
+
+    // how many counter ticks there are in a microsecond, measured over the whole run.
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - traceStartClock;
+    double ticksPerMicrosecond = (getTraceTime() - traceStartTime) / elapsed.count();
+
+    fprintf(file, "{\"traceEvents\": [\n");
+
+    bool isFirstEvent = true;
+    int totalBuffers = totalTraceBuffers.load() < MAX_TRACE_THREADS ? totalTraceBuffers.load() : MAX_TRACE_THREADS;
+
+    for (int i = 0; i < totalBuffers; i++)
+    {
+        const TraceBuffer *buffer = traceBuffers[i].load(std::memory_order_acquire);
+
+        // a thread that is still starting may have taken a slot without filling it yet.
+        if (buffer == nullptr)
+        {
+            continue;
+        }
+
+        int totalEvents = buffer->totalEvents.load(std::memory_order_acquire);
+
+        for (int j = 0; j < totalEvents; j++)
+        {
+            const TraceEvent &event = buffer->events[j];
+
+            // complete events, the times are in microseconds since the start of the program.
+            fprintf(file, "%s{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f}", isFirstEvent ? "" : ",\n", event.name, buffer->threadId, (event.start - traceStartTime) / ticksPerMicrosecond, (event.end - event.start) / ticksPerMicrosecond);
+            isFirstEvent = false;
+        }
+    }
+
+    fprintf(file, "\n]}\n");
+    fclose(file);
+}
+
+#endif
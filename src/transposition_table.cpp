@@ -0,0 +1,43 @@
+#include "transposition_table.h"
+#include <string.h>
+
+void clearTranspositionTable(TranspositionTable &table)
+{
+    for (int i = 0; i < TRANSPOSITION_TABLE_SIZE; i++)
+    {
+        table.entries[i].check.store(0, std::memory_order_relaxed);
+        table.entries[i].data.store(0, std::memory_order_relaxed);
+    }
+}
+
+bool probeTranspositionTable(const TranspositionTable &table, uint64_t key, float &value)
+{
+    const TranspositionEntry &entry = table.entries[key & (TRANSPOSITION_TABLE_SIZE - 1)];
+
+    uint64_t data = entry.data.load(std::memory_order_relaxed);
+    uint64_t check = entry.check.load(std::memory_order_relaxed);
+
+    // an empty entry has a check of 0, only the key 0 could match it.
+    if ((check ^ data) != key || key == 0)
+    {
+        return false;
+    }
+
+    uint32_t bits = (uint32_t)data;
+    memcpy(&value, &bits, sizeof(value));
+
+    return true;
+}
+
+void storeTranspositionTable(TranspositionTable &table, uint64_t key, float value)
+{
+    TranspositionEntry &entry = table.entries[key & (TRANSPOSITION_TABLE_SIZE - 1)];
+
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    uint64_t data = bits;
+
+    entry.data.store(data, std::memory_order_relaxed);
+    entry.check.store(key ^ data, std::memory_order_relaxed);
+}
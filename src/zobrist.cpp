@@ -0,0 +1,93 @@
+#include "zobrist.h"
+
+constexpr uint64_t nextKey(uint64_t &value)
+{
+    // splitmix64, the same mixing used to seed the games.
+    value += 0x9E3779B97F4A7C15;
+
+    uint64_t key = value;
+    key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9;
+    key = (key ^ (key >> 27)) * 0x94D049BB133111EB;
+
+    return key ^ (key >> 31);
+}
+
+constexpr ZobristKeys buildZobristKeys()
+{
+    ZobristKeys keys = {};
+    uint64_t value = 0x5A0B1A57;
+
+    for (int row = 0; row < TOTAL_ROWS; row++)
+    {
+        for (int chunk = 0; chunk < TOTAL_ROW_CHUNKS; chunk++)
+        {
+            uint64_t cellKeys[ROW_CHUNK_COLUMNS] = {};
+
+            for (int i = 0; i < ROW_CHUNK_COLUMNS; i++)
+            {
+                cellKeys[i] = nextKey(value);
+            }
+
+            for (int cells = 0; cells < 1 << ROW_CHUNK_COLUMNS; cells++)
+            {
+                for (int i = 0; i < ROW_CHUNK_COLUMNS; i++)
+                {
+                    if (cells & (1 << i))
+                    {
+                        keys.rowChunks[row][chunk][cells] ^= cellKeys[i];
+                    }
+                }
+            }
+        }
+    }
+
+    for (int id = 1; id <= TOTAL_BLOCK_TYPES; id++)
+    {
+        for (int rotation = 0; rotation < TOTAL_ROTATIONS; rotation++)
+        {
+            for (int row = 0; row < TOTAL_ROWS + BLOCK_KEY_BIAS; row++)
+            {
+                for (int column = 0; column < TOTAL_COLUMNS + BLOCK_KEY_BIAS; column++)
+                {
+                    keys.blocks[id][rotation][row][column] = nextKey(value);
+                }
+            }
+        }
+    }
+
+    for (int index = 0; index < MAX_PREVIEW_DEPTH; index++)
+    {
+        for (int id = 1; id <= TOTAL_BLOCK_TYPES; id++)
+        {
+            keys.previews[index][id] = nextKey(value);
+        }
+    }
+
+    return keys;
+}
+
+constexpr ZobristKeys ZOBRIST_KEYS = buildZobristKeys();
+
+uint64_t getBoardHash(const uint16_t rows[TOTAL_ROWS])
+{
+    uint64_t hash = 0;
+
+    for (int row = 0; row < TOTAL_ROWS; row++)
+    {
+        hash ^= getRowHash(row, rows[row]);
+    }
+
+    return hash;
+}
+
+uint64_t getPreviewHash(const PieceQueue &queue)
+{
+    uint64_t hash = 0;
+
+    for (int i = 0; i < queue.depth; i++)
+    {
+        hash ^= ZOBRIST_KEYS.previews[i][peekPiece(queue, i)];
+    }
+
+    return hash;
+}